@@ -0,0 +1,89 @@
+#ifdef UNIT_TEST
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "allocators/aligned_allocator.h"
+#include "data_structures/dynamic_array.h"
+
+/** Non-trivial element, so DynArray uses allocate and deallocate instead of reallocate. */
+struct Wrapped
+{
+    float value;
+
+    Wrapped(float x) : value(x) {}
+    Wrapped(const Wrapped &other) : value(other.value) {}
+};
+
+static bool isAligned(const void *p, size_t alignment)
+{
+    return (reinterpret_cast<uintptr_t>(p) & (alignment - 1)) == 0;
+}
+
+int main()
+{
+    static_assert(AlignedAlloc<float>::alignment == 64, "64 bytes by default");
+    static_assert(AlignedAlloc<float, 32>::alignment == 32, "explicit alignment");
+    static_assert(DynArray<float, AlignedAlloc<float>>::getAlignment() == 64, "DynArray picks up the alignment");
+    static_assert(DynArray<double, AlignedAlloc<double, 4096>>::getAlignment() == 4096, "DynArray picks up the alignment");
+
+    {
+        AlignedAlloc<float, 4096> ator;
+
+        float *buf = ator.allocate(10);
+        assert(isAligned(buf, 4096));
+        for (int i = 0; i < 10; i++) buf[i] = i;
+
+        buf = ator.reallocate(buf, 100000);
+        assert(isAligned(buf, 4096));
+        for (int i = 0; i < 10; i++) assert(buf[i] == i);
+
+        buf = ator.reallocate(buf, 5);
+        assert(isAligned(buf, 4096));
+        for (int i = 0; i < 5; i++) assert(buf[i] == i);
+
+        assert(!ator.reallocate(buf, SIZE_MAX / 2));
+        assert(buf[4] == 4); // Untouched on failure.
+
+        ator.deallocate(buf);
+    }
+
+    {
+        DynArray<float, AlignedAlloc<float>> arr;
+
+        for (int i = 0; i < 10000; i++)
+        {
+            assert(!arr.add(i));
+            assert(isAligned(arr.begin(), 64));
+        }
+
+        DynArray<float, AlignedAlloc<float>> copy = arr;
+        assert(isAligned(copy.begin(), 64));
+        assert(copy[9999] == 9999);
+
+        assert(!arr.setCapacity(20000));
+        assert(isAligned(arr.begin(), 64));
+        assert(arr[9999] == 9999);
+
+        DynArray<float, AlignedAlloc<float>> range = arr.getRange(1, 100);
+        assert(isAligned(range.begin(), 64));
+        assert(range[0] == 1);
+    }
+
+    {
+        DynArray<Wrapped, AlignedAlloc<Wrapped, 128>> arr;
+
+        for (int i = 0; i < 1000; i++)
+        {
+            assert(!arr.add(Wrapped(i)));
+            assert(isAligned(arr.begin(), 128));
+        }
+        assert(arr[999].value == 999);
+    }
+
+    printf("Passed: %s %s\n", __DATE__, __TIME__);
+
+    return 0;
+}
+
+#endif
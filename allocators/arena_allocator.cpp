@@ -0,0 +1,134 @@
+#ifdef UNIT_TEST
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "allocators/arena_allocator.h"
+#include "data_structures/dynamic_array.h"
+
+template <class T>
+struct Alloc
+{
+    T *allocate(size_t n) {return (T*)malloc(n * sizeof(T));}
+    T *reallocate(T* buf, size_t n) {return (T*)realloc(buf, n * sizeof(T)); }
+    void deallocate(T *buf) {free(buf);}
+};
+
+int main()
+{
+    {
+        Arena arena(1024);
+
+        char *a = static_cast<char*>(arena.allocate(10, 1));
+        assert(a);
+        memset(a, 'a', 10);
+
+        // The most recent allocation grows in place.
+        assert(arena.tryResize(a, 100));
+        assert(arena.reallocate(a, 200, 1) == a);
+
+        double *b = static_cast<double*>(arena.allocate(3 * sizeof(double), alignof(double)));
+        assert(b);
+        assert(reinterpret_cast<uintptr_t>(b) % alignof(double) == 0);
+        assert(reinterpret_cast<char*>(b) >= a + 200);
+
+        // Older allocations are copied.
+        assert(!arena.tryResize(a, 300));
+        char *moved = static_cast<char*>(arena.reallocate(a, 300, 1));
+        assert(moved && (moved != a));
+        for (int i = 0; i < 10; i++) assert(moved[i] == 'a');
+
+        // Freeing the most recent allocation gives its space back.
+        arena.deallocate(moved);
+        char *again = static_cast<char*>(arena.allocate(300, 1));
+        assert(again == moved);
+
+        // Larger than the block size.
+        void *big = arena.allocate(100000, 64);
+        assert(big);
+        assert(reinterpret_cast<uintptr_t>(big) % 64 == 0);
+        memset(big, 0, 100000);
+
+        // After reset the same memory is handed out again.
+        arena.reset();
+        char *first = static_cast<char*>(arena.allocate(10, 1));
+        assert(first == a);
+        assert(arena.allocate(900, 1));
+        void *bigAgain = arena.allocate(100000, 64); // Skips the small blocks that are too small.
+        assert(bigAgain);
+        memset(bigAgain, 0, 100000);
+
+        assert(!arena.allocate(SIZE_MAX / 2 + 1, 1));
+    }
+
+    {
+        ArenaAlloc<int> none;
+        assert(!none.allocate(1));
+        assert(!none.reallocate(nullptr, 1));
+        none.deallocate(nullptr);
+    }
+
+    {
+        Arena arena(1024 * 1024);
+        ArenaAlloc<int> ator(&arena);
+
+        DynArray<int, ArenaAlloc<int>> arr(ator);
+        for (int i = 0; i < 1000; i++)
+        {
+            assert(!arr.add(i));
+        }
+        int *start = arr.begin();
+
+        // Growth of the most recent allocation never moves.
+        for (int i = 1000; i < 10000; i++)
+        {
+            assert(!arr.add(i));
+        }
+        assert(arr.begin() == start);
+        assert(arr[9999] == 9999);
+
+        DynArray<int, ArenaAlloc<int>> copy = arr;
+        assert(copy.isAlive());
+        assert(copy[5000] == 5000);
+    }
+
+    {
+        // Heap backed source, arena backed results.
+        Arena arena;
+        DynArray<int, Alloc<int>> source;
+
+        for (int i = 0; i < 100; i++)
+        {
+            assert(!source.add(i));
+        }
+
+        for (int request = 0; request < 3; request++)
+        {
+            DynArray<int, ArenaAlloc<int>> odd = source.findAll([](int x){return x % 2;}, ArenaAlloc<int>(&arena));
+            assert(odd.getCount() == 50);
+            assert(odd[49] == 99);
+
+            DynArray<int, ArenaAlloc<int>> range = source.getRange(10, 20, ArenaAlloc<int>(&arena));
+            assert(range.getCount() == 20);
+            assert(range[0] == 10);
+
+            DynArray<double, ArenaAlloc<double>> halves =
+                source.convertAll<double>([](int x){return x / 2.0;}, ArenaAlloc<double>(&arena));
+            assert(halves.getCount() == 100);
+            assert(halves[99] == 49.5);
+
+            // Defaults still use the allocator of the source.
+            DynArray<int, Alloc<int>> heapRange = source.getRange(0, 5);
+            assert(heapRange.getCount() == 5);
+
+            arena.reset();
+        }
+    }
+
+    printf("Passed: %s %s\n", __DATE__, __TIME__);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,240 @@
+#ifndef ARENA_ALLOCATOR_H
+#define ARENA_ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * Monotonic memory arena.
+ *
+ * Allocation bumps a pointer in the current block, individual frees are no-ops except for the most recent
+ * allocation, which can also grow and shrink in place. reset() releases everything at once in O(1) and keeps the
+ * blocks for reuse, so a warmed up arena doesn't touch malloc at all.
+ *
+ * Not thread safe. Every allocation has a small size header, so the arena can copy it when it has to move.
+ */
+class Arena
+{
+    struct Block
+    {
+        Block *next; ///< The next block in the chain. Blocks after the current one are free for reuse.
+        size_t size; ///< Usable bytes after the block header.
+    };
+
+    /** Placed right before every allocation. */
+    struct AllocationHeader
+    {
+        size_t size; ///< Size of the allocation in bytes.
+    };
+
+    Block *head = nullptr; ///< The first block.
+    Block *current = nullptr; ///< The block allocations are served from.
+    char *top = nullptr; ///< The first free byte in the current block.
+    char *limit = nullptr; ///< The end of the current block.
+    char *last = nullptr; ///< The most recent allocation, it can be resized in place.
+    size_t blockSize; ///< The default size of a new block.
+
+    static char *alignUp(char *p, size_t align)
+    {
+        return reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(p) + align - 1) & ~(uintptr_t)(align - 1));
+    }
+
+    static char *blockStart(Block *block) {return reinterpret_cast<char*>(block + 1);}
+
+    static AllocationHeader *headerOf(void *p) {return static_cast<AllocationHeader*>(p) - 1;}
+
+    /**
+     * Moves to the next block that can hold the given number of bytes, allocating one if needed.
+     *
+     * @returns Zero on success, non-zero on failure.
+     */
+    int nextBlock(size_t bytes)
+    {
+        last = nullptr;
+
+        // Reuse the blocks left over from before the last reset.
+        while (current && current->next)
+        {
+            current = current->next;
+            top = blockStart(current);
+            limit = top + current->size;
+            if (bytes <= current->size) return 0;
+        }
+
+        size_t size = bytes > blockSize ? bytes : blockSize;
+        if (size > SIZE_MAX - sizeof(Block)) return -1;
+
+        Block *block = static_cast<Block*>(malloc(sizeof(Block) + size));
+        if (!block) return -1;
+
+        block->next = nullptr;
+        block->size = size;
+
+        if (current)
+        {
+            current->next = block;
+        }
+        else
+        {
+            head = block;
+        }
+
+        current = block;
+        top = blockStart(block);
+        limit = top + size;
+
+        return 0;
+    }
+
+public:
+    /**
+     * Creates an empty arena. No memory is allocated until the first allocation.
+     *
+     * @param[in] blockSize The size of the blocks requested from malloc. Larger allocations get their own block.
+     */
+    explicit Arena(size_t blockSize = 64 * 1024) : blockSize(blockSize) {}
+
+    Arena(const Arena &) = delete;
+    Arena& operator=(const Arena &) = delete;
+
+    /**
+     * Releases all blocks.
+     */
+    ~Arena()
+    {
+        while (head)
+        {
+            Block *next = head->next;
+            free(head);
+            head = next;
+        }
+    }
+
+    /**
+     * Allocates memory.
+     *
+     * @param[in] bytes The number of bytes.
+     * @param[in] align The alignment, must be a power of two.
+     * @returns The memory or nullptr if out of memory.
+     */
+    void *allocate(size_t bytes, size_t align)
+    {
+        if (align < alignof(AllocationHeader)) align = alignof(AllocationHeader);
+        if (bytes > SIZE_MAX / 2) return nullptr;
+
+        size_t needed = bytes + sizeof(AllocationHeader) + align - 1;
+
+        if (!top || (needed > (size_t)(limit - top)))
+        {
+            if (nextBlock(needed)) return nullptr;
+        }
+
+        char *p = alignUp(top + sizeof(AllocationHeader), align);
+        headerOf(p)->size = bytes;
+        top = p + bytes;
+        last = p;
+
+        return p;
+    }
+
+    /**
+     * Resizes an allocation. The most recent allocation is resized in place if it fits, others are copied.
+     *
+     * @returns The possibly moved memory or nullptr on failure, in which case the old memory is untouched.
+     */
+    void *reallocate(void *p, size_t bytes, size_t align)
+    {
+        if (!p) return allocate(bytes, align);
+        if (tryResize(p, bytes)) return p;
+
+        void *newP = allocate(bytes, align);
+        if (!newP) return nullptr;
+
+        size_t oldBytes = headerOf(p)->size;
+        memcpy(newP, p, oldBytes < bytes ? oldBytes : bytes);
+
+        return newP;
+    }
+
+    /**
+     * Resizes an allocation without moving it. Only the most recent allocation can be resized.
+     *
+     * @returns True on success.
+     */
+    bool tryResize(void *p, size_t bytes)
+    {
+        if ((p != last) || (bytes > (size_t)(limit - last))) return false;
+
+        headerOf(p)->size = bytes;
+        top = last + bytes;
+
+        return true;
+    }
+
+    /**
+     * Frees an allocation. Only has an effect on the most recent allocation, the space of others is reclaimed by
+     * reset().
+     */
+    void deallocate(void *p)
+    {
+        if (!p || (p != last)) return;
+
+        top = reinterpret_cast<char*>(headerOf(p));
+        last = nullptr;
+    }
+
+    /**
+     * Releases every allocation at once. The blocks are kept for reuse.
+     */
+    void reset()
+    {
+        current = head;
+        top = head ? blockStart(head) : nullptr;
+        limit = head ? top + head->size : nullptr;
+        last = nullptr;
+    }
+};
+
+/**
+ * Allocator for DynArray that allocates from an Arena.
+ *
+ * Growing the most recently allocated array is a pointer bump. Arrays using this allocator must not be used after
+ * the arena is reset or destroyed.
+ *
+ * @tparam T The element type.
+ */
+template <class T>
+struct ArenaAlloc
+{
+    Arena *arena = nullptr; ///< The arena to allocate from. A default constructed allocator fails every allocation.
+
+    ArenaAlloc() {}
+    ArenaAlloc(Arena *arena) : arena(arena) {}
+
+    T *allocate(size_t n)
+    {
+        if (!arena || (n > SIZE_MAX / sizeof(T))) return nullptr;
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    T *reallocate(T *buf, size_t n)
+    {
+        if (!arena || (n > SIZE_MAX / sizeof(T))) return nullptr;
+        return static_cast<T*>(arena->reallocate(buf, n * sizeof(T), alignof(T)));
+    }
+
+    bool tryExpand(T *buf, size_t oldN, size_t newN)
+    {
+        (void)oldN;
+        return arena && (newN <= SIZE_MAX / sizeof(T)) && arena->tryResize(buf, newN * sizeof(T));
+    }
+
+    void deallocate(T *buf)
+    {
+        if (arena) arena->deallocate(buf);
+    }
+};
+
+#endif
@@ -0,0 +1,76 @@
+#ifdef BENCHMARK
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "benchmark.h"
+#include "allocators/arena_allocator.h"
+#include "data_structures/dynamic_array.h"
+
+template <class T>
+struct Alloc
+{
+    T *allocate(size_t n) {return (T*)malloc(n * sizeof(T));}
+    T *reallocate(T* buf, size_t n) {return (T*)realloc(buf, n * sizeof(T)); }
+    void deallocate(T *buf) {free(buf);}
+};
+
+static const int REQUESTS = 1000000;
+static const uint32_t SOURCE_SIZE = 64;
+
+/**
+ * A request: a few filters, a slice and a conversion of the shared source data, all results are dropped at the end.
+ */
+template <class RAlloc, class DAlloc>
+static uint64_t handleRequest(DynArray<uint32_t, Alloc<uint32_t>> &source, uint32_t key, const RAlloc &ator,
+    const DAlloc &dator)
+{
+    uint64_t sum = 0;
+
+    for (uint32_t bit = 0; bit < 8; bit++)
+    {
+        DynArray<uint32_t, RAlloc> matches = source.findAll([=](uint32_t x){return ((x ^ key) >> bit) & 1;}, ator);
+        sum += matches.getCount();
+
+        DynArray<uint32_t, RAlloc> slice = source.getRange(bit * 8, 8, ator);
+        sum += slice[7];
+    }
+
+    DynArray<uint32_t, RAlloc> range = source.getRange(key % 32, 32, ator);
+    sum += range[0];
+
+    DynArray<double, DAlloc> converted = range.template convertAll<double>([](uint32_t x){return x * 0.5;}, dator);
+    sum += converted.getCount();
+
+    return sum;
+}
+
+int main()
+{
+    DynArray<uint32_t, Alloc<uint32_t>> source;
+
+    for (uint32_t i = 0; i < SOURCE_SIZE; i++) source.add(i * 2654435761u);
+
+    uint64_t sum = 0;
+    double start = benchNow();
+    for (int r = 0; r < REQUESTS; r++)
+    {
+        sum += handleRequest(source, r, Alloc<uint32_t>(), Alloc<double>());
+    }
+    benchReport("filter request loop, malloc", benchNow() - start, REQUESTS);
+
+    Arena arena;
+    start = benchNow();
+    for (int r = 0; r < REQUESTS; r++)
+    {
+        sum += handleRequest(source, r, ArenaAlloc<uint32_t>(&arena), ArenaAlloc<double>(&arena));
+        arena.reset();
+    }
+    benchReport("filter request loop, arena", benchNow() - start, REQUESTS);
+
+    benchKeep(sum);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,183 @@
+#ifdef UNIT_TEST
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "allocators/mmap_allocator.h"
+#include "data_structures/dynamic_array.h"
+
+typedef MmapAlloc<uint64_t, 16 * 1024> SmallThresholdAlloc;
+
+/**
+ * @returns The number of resident pages in the range.
+ */
+static size_t residentPages(void *start, size_t length)
+{
+    size_t page = sysconf(_SC_PAGESIZE);
+    uintptr_t first = reinterpret_cast<uintptr_t>(start) & ~(page - 1);
+    size_t count = (reinterpret_cast<uintptr_t>(start) + length - first + page - 1) / page;
+    unsigned char vec[4096];
+    size_t resident = 0;
+
+    assert(count <= sizeof(vec));
+    assert(mincore(reinterpret_cast<void*>(first), count * page, vec) == 0);
+
+    for (size_t i = 0; i < count; i++) resident += vec[i] & 1;
+
+    return resident;
+}
+
+/**
+ * Grows an array through the allocator and checks the contents survive.
+ */
+template <class A> static void checkGrowth(size_t count)
+{
+    DynArray<uint64_t, A> arr;
+
+    for (uint64_t i = 0; i < count; i++)
+    {
+        assert(!arr.add(i));
+    }
+
+    for (uint64_t i = 0; i < count; i++)
+    {
+        assert(arr[i] == i);
+    }
+}
+
+int main()
+{
+    SmallThresholdAlloc ator;
+
+    // Small blocks come from malloc.
+    uint64_t *small = ator.allocate(16);
+    assert(small);
+    assert(ator.usableSize(small) >= 16);
+    for (uint64_t i = 0; i < 16; i++) small[i] = i;
+
+    // Crossing the threshold moves the data into a mapping.
+    uint64_t *big = ator.reallocate(small, 4096);
+    assert(big);
+    assert(ator.usableSize(big) >= 4096);
+    for (uint64_t i = 0; i < 16; i++) assert(big[i] == i);
+    for (uint64_t i = 16; i < 4096; i++) big[i] = i;
+
+    // Mapped blocks are remapped.
+    uint64_t *bigger = ator.reallocate(big, 1024 * 1024);
+    assert(bigger);
+    for (uint64_t i = 0; i < 4096; i++) assert(bigger[i] == i);
+    bigger[1024 * 1024 - 1] = 42;
+
+    // Shrinking keeps the prefix.
+    uint64_t *shrunk = ator.reallocate(bigger, 100);
+    assert(shrunk);
+    for (uint64_t i = 0; i < 100; i++) assert(shrunk[i] == i);
+
+    // In place expansion is only done for mappings.
+    uint64_t *mallocd = ator.allocate(4);
+    assert(!ator.tryExpand(mallocd, 4, 8));
+    ator.deallocate(mallocd);
+
+    size_t usable = ator.usableSize(shrunk);
+    assert(ator.tryExpand(shrunk, 100, usable)); // Fits into the pages we already have.
+    if (ator.tryExpand(shrunk, usable, 2 * usable))
+    {
+        assert(ator.usableSize(shrunk) >= 2 * usable);
+        shrunk[2 * usable - 1] = 1;
+    }
+    ator.deallocate(shrunk);
+    ator.deallocate(nullptr);
+
+    assert(!ator.allocate(SIZE_MAX / 4));
+
+    {
+        DynArray<uint64_t, SmallThresholdAlloc> arr;
+
+        for (uint64_t i = 0; i < 100000; i++)
+        {
+            assert(!arr.add(i));
+        }
+        assert(arr.getCount() == 100000);
+        assert(arr.getCapacity() >= 100000);
+
+        uint64_t expected = 0;
+        for (uint64_t x : arr)
+        {
+            assert(x == expected);
+            expected++;
+        }
+
+        DynArray<uint64_t, SmallThresholdAlloc> copy = arr;
+        assert(copy.isAlive());
+        assert(copy[99999] == 99999);
+
+        arr.clear();
+        assert(!arr.setCapacity(10));
+        assert(!arr.setCapacity(0));
+    }
+
+    {
+        // Prefaulted buffers are resident before the first write, also after a growth.
+        MmapAlloc<uint64_t, 0, MMAP_ALLOC_POPULATE> populating;
+        MmapAlloc<uint64_t, 0> lazy;
+
+        uint64_t *buf = populating.allocate(64 * 1024);
+        assert(residentPages(buf, 64 * 1024 * sizeof(uint64_t)) == 129);
+        buf = populating.reallocate(buf, 256 * 1024);
+        assert(buf);
+        assert(residentPages(buf, 256 * 1024 * sizeof(uint64_t)) == 513);
+        populating.deallocate(buf);
+
+        buf = lazy.allocate(64 * 1024);
+        assert(residentPages(buf, 64 * 1024 * sizeof(uint64_t)) < 129);
+        lazy.deallocate(buf);
+
+        checkGrowth<MmapAlloc<uint64_t, 0, MMAP_ALLOC_POPULATE>>(100000);
+    }
+
+    {
+        // Transparent huge pages: the mapping is aligned to the huge page size.
+        MmapAlloc<uint64_t, 0, MMAP_ALLOC_TRANSPARENT_HUGE_PAGES> thp;
+
+        uint64_t *buf = thp.allocate(1024 * 1024);
+        assert(buf);
+        assert((reinterpret_cast<uintptr_t>(buf) & (2 * 1024 * 1024 - 1)) == sizeof(MmapAllocHeader));
+        thp.deallocate(buf);
+
+        checkGrowth<MmapAlloc<uint64_t, 0, MMAP_ALLOC_TRANSPARENT_HUGE_PAGES | MMAP_ALLOC_POPULATE>>(1000000);
+    }
+
+    {
+        // Explicit huge pages fall back to normal pages when none are reserved.
+        checkGrowth<MmapAlloc<uint64_t, 0, MMAP_ALLOC_HUGETLB>>(1000000);
+    }
+
+    {
+        // Locked buffers are resident. Stay well under the default RLIMIT_MEMLOCK.
+        MmapAlloc<uint64_t, 0, MMAP_ALLOC_MLOCK> locking;
+
+        uint64_t *buf = locking.allocate(16 * 1024);
+        if (buf)
+        {
+            assert(residentPages(buf, 16 * 1024 * sizeof(uint64_t)) == 33);
+            buf = locking.reallocate(buf, 64 * 1024);
+            assert(buf);
+            assert(residentPages(buf, 64 * 1024 * sizeof(uint64_t)) == 129);
+            locking.deallocate(buf);
+        }
+        else
+        {
+            printf("mlock is not permitted here, skipping.\n");
+        }
+
+        assert(!locking.allocate(SIZE_MAX / 16)); // Fails cleanly.
+    }
+
+    printf("Passed: %s %s\n", __DATE__, __TIME__);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,307 @@
+#ifndef MMAP_ALLOCATOR_H
+#define MMAP_ALLOCATOR_H
+
+#include <malloc.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * Options for MmapAlloc. They can be combined with bitwise or, each applies to mapped buffers only.
+ */
+enum MmapAllocFlags : unsigned
+{
+    MMAP_ALLOC_DEFAULT = 0,
+    MMAP_ALLOC_TRANSPARENT_HUGE_PAGES = 1, ///< 2 MB aligned mappings with madvise(MADV_HUGEPAGE).
+    MMAP_ALLOC_HUGETLB = 2, ///< Explicit huge pages via MAP_HUGETLB. Falls back to normal pages if the pool is empty.
+    MMAP_ALLOC_POPULATE = 4, ///< Prefault the pages when a buffer is mapped or grown, so the first access doesn't fault.
+    MMAP_ALLOC_MLOCK = 8 ///< Lock the pages into memory. Allocation fails if they can't be locked (see RLIMIT_MEMLOCK).
+};
+
+/**
+ * Header placed in front of every buffer handed out by MmapAlloc.
+ */
+struct MmapAllocHeader
+{
+    size_t mappedBytes; ///< The size of the mapping including the header. Zero if the block came from malloc.
+    size_t hugeTlb; ///< Non-zero if the mapping is backed by explicit huge pages. Also keeps the buffer 16 byte aligned.
+};
+
+/**
+ * Allocator for DynArray that serves large buffers straight from mmap and grows them with mremap.
+ *
+ * Small buffers come from malloc. Once a buffer reaches the threshold it's moved to its own mapping, further growth
+ * remaps the pages to a larger virtual range instead of copying them, so growing a multi-gigabyte array costs page
+ * table updates only.
+ *
+ * For latency critical arrays the Flags can ask for huge pages to reduce TLB misses, prefaulting to take the page
+ * faults out of the first access after a growth, and locking to keep the pages from being swapped out. Set the
+ * threshold to zero to apply them to every buffer.
+ *
+ * Linux only.
+ *
+ * @tparam T The element type. Must not need alignment stricter than 16 bytes.
+ * @tparam ThresholdBytes Buffers of at least this many bytes are mapped.
+ * @tparam Flags A combination of MmapAllocFlags.
+ */
+template <class T, size_t ThresholdBytes = 1024 * 1024, unsigned Flags = MMAP_ALLOC_DEFAULT>
+struct MmapAlloc
+{
+    static_assert(alignof(T) <= sizeof(MmapAllocHeader), "MmapAlloc supports up to 16 byte alignment.");
+
+    static const size_t HEADER = sizeof(MmapAllocHeader);
+    static const size_t HUGE_PAGE = 2 * 1024 * 1024;
+
+    /**
+     * Allocates a buffer for n elements.
+     *
+     * @returns The buffer or nullptr on failure.
+     */
+    T *allocate(size_t n)
+    {
+        size_t bytes;
+        if (totalBytes(n, bytes)) return nullptr;
+
+        MmapAllocHeader *header = bytes >= ThresholdBytes ? mapBlock(bytes) : mallocBlock(bytes);
+
+        return header ? toBuffer(header) : nullptr;
+    }
+
+    /**
+     * Resizes the buffer to n elements, the contents are preserved up to the smaller size.
+     *
+     * @returns The new buffer or nullptr on failure in which case the old buffer is untouched.
+     */
+    T *reallocate(T *buf, size_t n)
+    {
+        if (!buf) return allocate(n);
+
+        size_t bytes;
+        if (totalBytes(n, bytes)) return nullptr;
+
+        MmapAllocHeader *header = toHeader(buf);
+
+        if (header->mappedBytes)
+        {
+            size_t oldMapped = header->mappedBytes;
+            size_t newMapped = roundToPages(bytes, header->hugeTlb);
+            void *p = mremap(header, oldMapped, newMapped, MREMAP_MAYMOVE);
+
+            if (p == MAP_FAILED)
+            {
+                // Older kernels can't remap huge pages, copy those.
+                return header->hugeTlb ? copyToNewMapping(header, bytes) : nullptr;
+            }
+
+            header = static_cast<MmapAllocHeader*>(p);
+            header->mappedBytes = newMapped;
+            prepareGrownRange(header, oldMapped);
+
+            return toBuffer(header);
+        }
+
+        if (bytes < ThresholdBytes)
+        {
+            header = static_cast<MmapAllocHeader*>(realloc(header, bytes));
+            return header ? toBuffer(header) : nullptr;
+        }
+
+        // Crossing the threshold: the only growth step that copies.
+        MmapAllocHeader *newHeader = mapBlock(bytes);
+        if (!newHeader) return nullptr;
+
+        size_t oldBytes = malloc_usable_size(header);
+        memcpy(newHeader + 1, header + 1, (oldBytes < bytes ? oldBytes : bytes) - HEADER);
+        free(header);
+
+        return toBuffer(newHeader);
+    }
+
+    /**
+     * Grows a mapped buffer without moving it, if the address space right after it is free.
+     *
+     * @returns True on success.
+     */
+    bool tryExpand(T *buf, size_t oldN, size_t newN)
+    {
+        (void)oldN;
+
+        size_t bytes;
+        if (totalBytes(newN, bytes)) return false;
+
+        MmapAllocHeader *header = toHeader(buf);
+        if (!header->mappedBytes) return false;
+
+        size_t oldMapped = header->mappedBytes;
+        size_t newMapped = roundToPages(bytes, header->hugeTlb);
+        if (newMapped <= oldMapped) return true;
+
+        if (mremap(header, oldMapped, newMapped, 0) == MAP_FAILED) return false;
+        header->mappedBytes = newMapped;
+        prepareGrownRange(header, oldMapped);
+
+        return true;
+    }
+
+    /**
+     * @returns The number of elements that fit into the buffer, mappings are rounded up to whole pages.
+     */
+    size_t usableSize(T *buf)
+    {
+        MmapAllocHeader *header = toHeader(buf);
+        size_t bytes = header->mappedBytes ? header->mappedBytes : malloc_usable_size(header);
+
+        return (bytes - HEADER) / sizeof(T);
+    }
+
+    /**
+     * Releases the buffer.
+     */
+    void deallocate(T *buf)
+    {
+        if (!buf) return;
+
+        MmapAllocHeader *header = toHeader(buf);
+
+        if (header->mappedBytes)
+        {
+            munmap(header, header->mappedBytes);
+        }
+        else
+        {
+            free(header);
+        }
+    }
+
+private:
+    static int totalBytes(size_t n, size_t &bytes)
+    {
+        if (n > (SIZE_MAX - HEADER) / sizeof(T) - 2 * 1024 * 1024) return -1; // Leave room for the page rounding.
+        bytes = n * sizeof(T) + HEADER;
+        return 0;
+    }
+
+    static size_t roundToPages(size_t bytes, bool hugeTlb = false)
+    {
+        size_t page = hugeTlb ? HUGE_PAGE : sysconf(_SC_PAGESIZE);
+        return (bytes + page - 1) / page * page;
+    }
+
+    static MmapAllocHeader *mapBlock(size_t bytes)
+    {
+        const int prot = PROT_READ | PROT_WRITE;
+        const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+        void *p = MAP_FAILED;
+        size_t mapped = 0;
+        bool hugeTlb = false;
+
+        if (Flags & MMAP_ALLOC_HUGETLB)
+        {
+            mapped = roundToPages(bytes, true);
+            p = mmap(nullptr, mapped, prot, flags | MAP_HUGETLB | (Flags & MMAP_ALLOC_POPULATE ? MAP_POPULATE : 0), -1, 0);
+            hugeTlb = p != MAP_FAILED;
+        }
+
+        if ((p == MAP_FAILED) && (Flags & MMAP_ALLOC_TRANSPARENT_HUGE_PAGES))
+        {
+            // Over-map and trim, so the mapping starts on a huge page boundary.
+            mapped = roundToPages(bytes);
+            p = mmap(nullptr, mapped + HUGE_PAGE, prot, flags, -1, 0);
+
+            if (p != MAP_FAILED)
+            {
+                char *start = static_cast<char*>(p);
+                char *aligned = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(start) + HUGE_PAGE - 1) & ~(HUGE_PAGE - 1));
+
+                if (aligned > start) munmap(start, aligned - start);
+                munmap(aligned + mapped, start + HUGE_PAGE - aligned);
+                p = aligned;
+
+                madvise(p, mapped, MADV_HUGEPAGE);
+                if (Flags & MMAP_ALLOC_POPULATE) populate(static_cast<char*>(p), mapped);
+            }
+        }
+
+        if (p == MAP_FAILED)
+        {
+            mapped = roundToPages(bytes);
+            p = mmap(nullptr, mapped, prot, flags | (Flags & MMAP_ALLOC_POPULATE ? MAP_POPULATE : 0), -1, 0);
+            if (p == MAP_FAILED) return nullptr;
+        }
+
+        if ((Flags & MMAP_ALLOC_MLOCK) && mlock(p, mapped))
+        {
+            munmap(p, mapped);
+            return nullptr;
+        }
+
+        MmapAllocHeader *header = static_cast<MmapAllocHeader*>(p);
+        header->mappedBytes = mapped;
+        header->hugeTlb = hugeTlb;
+
+        return header;
+    }
+
+    /**
+     * Applies the options to the pages added by a remap. Locks are carried over by the kernel.
+     */
+    static void prepareGrownRange(MmapAllocHeader *header, size_t oldMapped)
+    {
+        char *start = reinterpret_cast<char*>(header);
+
+        if (header->hugeTlb) return; // Huge TLB pages are reserved up front.
+
+        if (Flags & MMAP_ALLOC_TRANSPARENT_HUGE_PAGES) madvise(start, header->mappedBytes, MADV_HUGEPAGE);
+        if (Flags & MMAP_ALLOC_POPULATE) populate(start + oldMapped, header->mappedBytes - oldMapped);
+    }
+
+    /**
+     * Faults in the given fresh pages for writing.
+     */
+    static void populate(char *start, size_t length)
+    {
+#ifdef MADV_POPULATE_WRITE
+        if (madvise(start, length, MADV_POPULATE_WRITE) == 0) return;
+#endif
+        size_t page = sysconf(_SC_PAGESIZE);
+        volatile char *p = start;
+
+        for (size_t offset = 0; offset < length; offset += page)
+        {
+            p[offset] = 0; // The pages are fresh, there's no data to overwrite.
+        }
+    }
+
+    static T *copyToNewMapping(MmapAllocHeader *header, size_t bytes)
+    {
+        MmapAllocHeader *newHeader = mapBlock(bytes);
+        if (!newHeader) return nullptr;
+
+        size_t oldBytes = header->mappedBytes;
+        memcpy(newHeader + 1, header + 1, (oldBytes < bytes ? oldBytes : bytes) - HEADER);
+        munmap(header, header->mappedBytes);
+
+        return toBuffer(newHeader);
+    }
+
+    static MmapAllocHeader *mallocBlock(size_t bytes)
+    {
+        MmapAllocHeader *header = static_cast<MmapAllocHeader*>(malloc(bytes));
+
+        if (header)
+        {
+            header->mappedBytes = 0;
+            header->hugeTlb = 0;
+        }
+
+        return header;
+    }
+
+    static T *toBuffer(MmapAllocHeader *header) {return reinterpret_cast<T*>(header + 1);}
+    static MmapAllocHeader *toHeader(T *buf) {return reinterpret_cast<MmapAllocHeader*>(buf) - 1;}
+};
+
+#endif
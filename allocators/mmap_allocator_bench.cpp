@@ -0,0 +1,142 @@
+#ifdef BENCHMARK
+#include <malloc.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "benchmark.h"
+#include "allocators/mmap_allocator.h"
+#include "data_structures/dynamic_array.h"
+
+/** The malloc based allocator from dynamic_array.cpp. */
+template <class T>
+struct Alloc
+{
+    T *allocate(size_t n) {return (T*)malloc(n * sizeof(T));}
+    T *reallocate(T* buf, size_t n) {return (T*)realloc(buf, n * sizeof(T)); }
+    void deallocate(T *buf) {free(buf);}
+    size_t usableSize(T *buf) {return malloc_usable_size(buf) / sizeof(T);}
+};
+
+/** Measures the time spent in reallocate, the rest of the interface is inherited. */
+template <class Base>
+struct TimedAlloc : Base
+{
+    static double seconds;
+
+    uint64_t *reallocate(uint64_t *buf, size_t n)
+    {
+        double start = benchNow();
+        uint64_t *newBuf = Base::reallocate(buf, n);
+        seconds += benchNow() - start;
+        return newBuf;
+    }
+};
+
+template <class Base> double TimedAlloc<Base>::seconds = 0;
+
+/**
+ * Grows an array to the given size in a child process, so an out of memory condition only takes down the child.
+ */
+template <class A> static void benchGrowTo(const char *name, size_t count)
+{
+    fflush(stdout);
+
+    pid_t pid = fork();
+
+    if (pid == 0)
+    {
+        DynArray<uint64_t, TimedAlloc<A>> arr;
+
+        double start = benchNow();
+        for (size_t i = 0; i < count; i++)
+        {
+            if (arr.add(i)) _exit(1);
+        }
+        double elapsed = benchNow() - start;
+
+        benchReport(name, elapsed, count);
+        printf("%-48s %10.3f ms in reallocate\n", "", TimedAlloc<A>::seconds * 1e3);
+        fflush(stdout);
+        _exit(0);
+    }
+
+    int status;
+    struct rusage usage;
+
+    if ((pid < 0) || (wait4(pid, &status, 0, &usage) < 0) || !WIFEXITED(status) || WEXITSTATUS(status))
+    {
+        printf("%-48s failed (out of memory?)\n", name);
+        return;
+    }
+
+    printf("%-48s %10.1f MB peak RSS\n", "", usage.ru_maxrss / 1024.0);
+}
+
+/**
+ * Measures the cost of making room for count elements, the first write pass over them and random reads.
+ */
+template <class A> static void benchLatency(const char *name, size_t count)
+{
+    DynArray<uint64_t, A> arr;
+    char line[96];
+
+    double start = benchNow();
+    if (arr.setCapacity(count))
+    {
+        printf("%-48s failed\n", name);
+        return;
+    }
+    snprintf(line, sizeof(line), "%s: setCapacity", name);
+    benchReport(line, benchNow() - start, 1);
+
+    start = benchNow();
+    for (size_t i = 0; i < count; i++) arr.add(i);
+    snprintf(line, sizeof(line), "%s: first add pass", name);
+    benchReport(line, benchNow() - start, count);
+
+    uint64_t sum = 0;
+    uint64_t x = 12345;
+    const size_t reads = 16 * 1024 * 1024;
+
+    start = benchNow();
+    for (size_t i = 0; i < reads; i++)
+    {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        sum += arr.begin()[(x >> 16) % count];
+    }
+    benchKeep(sum);
+    snprintf(line, sizeof(line), "%s: random reads", name);
+    benchReport(line, benchNow() - start, reads);
+}
+
+/**
+ * Usage: benchprogram [size in MB], the default is 8192.
+ */
+int main(int argc, char **argv)
+{
+    size_t megabytes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 8192;
+    size_t count = megabytes * 1024 * 1024 / sizeof(uint64_t);
+    char name[64];
+
+    snprintf(name, sizeof(name), "grow to %zu MB, malloc", megabytes);
+    benchGrowTo<Alloc<uint64_t>>(name, count);
+    snprintf(name, sizeof(name), "grow to %zu MB, mmap/mremap", megabytes);
+    benchGrowTo<MmapAlloc<uint64_t>>(name, count);
+
+    const size_t latencyCount = 1024 * 1024 * 1024 / sizeof(uint64_t);
+    benchLatency<MmapAlloc<uint64_t>>("1 GB, default", latencyCount);
+    benchLatency<MmapAlloc<uint64_t, 0, MMAP_ALLOC_POPULATE>>("1 GB, populate", latencyCount);
+    benchLatency<MmapAlloc<uint64_t, 0, MMAP_ALLOC_TRANSPARENT_HUGE_PAGES>>("1 GB, THP", latencyCount);
+    benchLatency<MmapAlloc<uint64_t, 0, MMAP_ALLOC_TRANSPARENT_HUGE_PAGES | MMAP_ALLOC_POPULATE>>("1 GB, THP + populate",
+        latencyCount);
+    benchLatency<MmapAlloc<uint64_t, 0, MMAP_ALLOC_HUGETLB | MMAP_ALLOC_POPULATE>>("1 GB, hugetlb + populate",
+        latencyCount);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,110 @@
+#ifdef UNIT_TEST
+#include <stdio.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include <thread>
+
+#include "allocators/pool_allocator.h"
+#include "data_structures/dynamic_array.h"
+
+/**
+ * Builds many small arrays and checks their contents.
+ */
+static void buildArrays(int seed)
+{
+    for (int round = 0; round < 200; round++)
+    {
+        DynArray<DynArray<int, PoolAlloc<int>>, PoolAlloc<DynArray<int, PoolAlloc<int>>>> arrays;
+
+        for (int i = 0; i < 50; i++)
+        {
+            DynArray<int, PoolAlloc<int>> arr;
+
+            for (int j = 0; j < i; j++)
+            {
+                assert(!arr.add(seed + j));
+            }
+            assert(!arrays.add(arr));
+        }
+
+        for (int i = 0; i < 50; i++)
+        {
+            assert(arrays[i].getCount() == (size_t)i);
+            for (int j = 0; j < i; j++) assert(arrays[i][j] == seed + j);
+        }
+    }
+}
+
+int main()
+{
+    assert(SizeClassPool::classOf(1) == 0);
+    assert(SizeClassPool::classOf(16) == 0);
+    assert(SizeClassPool::classOf(17) == 1);
+    assert(SizeClassPool::classOf(32768) == 11);
+    assert(SizeClassPool::classOf(32769) == SizeClassPool::LARGE);
+
+    {
+        // Freed blocks are reused by the same thread.
+        void *a = SizeClassPool::allocate(100);
+        assert(SizeClassPool::usableSize(a) == 128);
+        SizeClassPool::deallocate(a);
+        void *b = SizeClassPool::allocate(120);
+        assert(a == b);
+
+        // Staying within the class doesn't move.
+        assert(SizeClassPool::reallocate(b, 128) == b);
+        memset(b, 7, 128);
+
+        void *c = SizeClassPool::reallocate(b, 1000);
+        assert(c != b);
+        assert(SizeClassPool::usableSize(c) == 1024);
+        for (int i = 0; i < 128; i++) assert(static_cast<char*>(c)[i] == 7);
+
+        void *large = SizeClassPool::reallocate(c, 100000);
+        assert(large);
+        assert(SizeClassPool::usableSize(large) >= 100000);
+        for (int i = 0; i < 128; i++) assert(static_cast<char*>(large)[i] == 7);
+
+        large = SizeClassPool::reallocate(large, 200000);
+        assert(large);
+        for (int i = 0; i < 128; i++) assert(static_cast<char*>(large)[i] == 7);
+
+        void *small = SizeClassPool::reallocate(large, 16);
+        for (int i = 0; i < 16; i++) assert(static_cast<char*>(small)[i] == 7);
+        SizeClassPool::deallocate(small);
+        SizeClassPool::deallocate(nullptr);
+
+        // Overflowing the thread cache sends batches to the depot and back.
+        void *blocks[1000];
+        for (int i = 0; i < 1000; i++) blocks[i] = SizeClassPool::allocate(64);
+        for (int i = 0; i < 1000; i++) SizeClassPool::deallocate(blocks[i]);
+        for (int i = 0; i < 1000; i++) blocks[i] = SizeClassPool::allocate(64);
+        for (int i = 0; i < 1000; i++) SizeClassPool::deallocate(blocks[i]);
+    }
+
+    {
+        DynArray<int, PoolAlloc<int>> arr;
+
+        assert(!arr.add(1));
+        assert(arr.getCapacity() == 8);
+        for (int i = 0; i < 100000; i++) assert(!arr.add(i));
+        assert(arr[100000] == 99999);
+    }
+
+    {
+        // Blocks freed by one thread are reused by others through the depot.
+        std::thread threads[8];
+
+        for (int i = 0; i < 8; i++) threads[i] = std::thread(buildArrays, i * 1000);
+        for (int i = 0; i < 8; i++) threads[i].join();
+
+        buildArrays(-1);
+    }
+
+    printf("Passed: %s %s\n", __DATE__, __TIME__);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,293 @@
+#ifndef POOL_ALLOCATOR_H
+#define POOL_ALLOCATOR_H
+
+#include <malloc.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mutex>
+
+/**
+ * Size-class pool with per-thread caches.
+ *
+ * Blocks are served from power-of-two size classes between 16 bytes and 32 KB. Each thread keeps its own free lists,
+ * so the common allocate/free path takes no lock. Threads exchange blocks with a shared depot in batches when their
+ * lists run empty or grow too long. Larger requests go straight to malloc.
+ *
+ * Blocks are never returned to the system while the process runs, the depot releases them at exit.
+ */
+class SizeClassPool
+{
+public:
+    static const int CLASSES = 12; ///< 16 bytes to 32 KB.
+    static const int LARGE = CLASSES; ///< Class index of blocks served by malloc.
+    static const size_t MIN_SIZE = 16;
+    static const size_t MAX_SIZE = MIN_SIZE << (CLASSES - 1);
+    static const size_t BATCH = 32; ///< Number of blocks moved between a thread and the depot at once.
+    static const size_t MAX_CACHED = 2 * BATCH; ///< A thread returns a batch to the depot above this.
+
+    /** Placed in front of every block. */
+    struct Header
+    {
+        size_t sizeClass; ///< Index of the size class, LARGE for malloc'd blocks.
+        size_t reserved; ///< Keeps the payload 16 byte aligned.
+    };
+
+    /**
+     * @returns The size class that fits the given number of bytes or LARGE.
+     */
+    static int classOf(size_t bytes)
+    {
+        if (bytes > MAX_SIZE) return LARGE;
+
+        int c = 0;
+        while ((MIN_SIZE << c) < bytes) c++;
+
+        return c;
+    }
+
+    /**
+     * @returns The payload size of a size class.
+     */
+    static size_t classSize(int c) {return MIN_SIZE << c;}
+
+    /**
+     * Allocates a block that can hold the given number of bytes.
+     *
+     * @returns The payload or nullptr on failure.
+     */
+    static void *allocate(size_t bytes)
+    {
+        int c = classOf(bytes);
+
+        if (c == LARGE)
+        {
+            if (bytes > SIZE_MAX - sizeof(Header)) return nullptr;
+
+            Header *header = static_cast<Header*>(malloc(sizeof(Header) + bytes));
+            if (!header) return nullptr;
+
+            header->sizeClass = LARGE;
+            return header + 1;
+        }
+
+        ThreadCache &cache = threadCache();
+        if (!cache.lists[c] && cache.refill(c)) return nullptr;
+
+        FreeNode *node = cache.lists[c];
+        cache.lists[c] = node->next;
+        cache.counts[c]--;
+
+        Header *header = reinterpret_cast<Header*>(node);
+        header->sizeClass = c;
+
+        return header + 1;
+    }
+
+    /**
+     * Returns a block to the calling thread's cache.
+     */
+    static void deallocate(void *p)
+    {
+        if (!p) return;
+
+        Header *header = static_cast<Header*>(p) - 1;
+        int c = header->sizeClass;
+
+        if (c == LARGE)
+        {
+            free(header);
+            return;
+        }
+
+        ThreadCache &cache = threadCache();
+        FreeNode *node = reinterpret_cast<FreeNode*>(header);
+
+        node->next = cache.lists[c];
+        cache.lists[c] = node;
+        if (++cache.counts[c] > MAX_CACHED) cache.flush(c, BATCH);
+    }
+
+    /**
+     * @returns The number of bytes that fit into the block.
+     */
+    static size_t usableSize(void *p)
+    {
+        Header *header = static_cast<Header*>(p) - 1;
+
+        if (header->sizeClass == LARGE) return malloc_usable_size(header) - sizeof(Header);
+
+        return classSize(header->sizeClass);
+    }
+
+    /**
+     * Resizes a block. Stays in place if the block already fits and isn't more than twice as big as needed.
+     *
+     * @returns The possibly moved block or nullptr on failure, in which case the old block is untouched.
+     */
+    static void *reallocate(void *p, size_t bytes)
+    {
+        if (!p) return allocate(bytes);
+
+        Header *header = static_cast<Header*>(p) - 1;
+        int c = classOf(bytes);
+
+        if ((c == LARGE) && (header->sizeClass == LARGE))
+        {
+            if (bytes > SIZE_MAX - sizeof(Header)) return nullptr;
+
+            header = static_cast<Header*>(realloc(header, sizeof(Header) + bytes));
+            return header ? header + 1 : nullptr;
+        }
+
+        if ((size_t)c == header->sizeClass) return p;
+
+        void *newP = allocate(bytes);
+        if (!newP) return nullptr;
+
+        size_t oldBytes = usableSize(p);
+        memcpy(newP, p, oldBytes < bytes ? oldBytes : bytes);
+        deallocate(p);
+
+        return newP;
+    }
+
+private:
+    struct FreeNode
+    {
+        FreeNode *next;
+    };
+
+    /** The shared free lists. */
+    struct Depot
+    {
+        std::mutex lock;
+        FreeNode *lists[CLASSES] = {};
+
+        ~Depot()
+        {
+            for (int c = 0; c < CLASSES; c++)
+            {
+                while (lists[c])
+                {
+                    FreeNode *next = lists[c]->next;
+                    free(lists[c]);
+                    lists[c] = next;
+                }
+            }
+        }
+    };
+
+    /** The free lists of a thread. Handed back to the depot when the thread exits. */
+    struct ThreadCache
+    {
+        FreeNode *lists[CLASSES] = {};
+        size_t counts[CLASSES] = {};
+        Depot &depot;
+
+        ThreadCache() : depot(SizeClassPool::depot()) {} // Constructing the depot first makes it outlive the cache.
+
+        ~ThreadCache()
+        {
+            for (int c = 0; c < CLASSES; c++) flush(c, counts[c]);
+        }
+
+        /**
+         * Takes a batch from the depot, or allocates one if the depot is empty.
+         *
+         * @returns Zero on success, non-zero if no block could be allocated.
+         */
+        int refill(int c)
+        {
+            {
+                std::lock_guard<std::mutex> guard(depot.lock);
+
+                while (depot.lists[c] && (counts[c] < BATCH))
+                {
+                    FreeNode *node = depot.lists[c];
+                    depot.lists[c] = node->next;
+                    node->next = lists[c];
+                    lists[c] = node;
+                    counts[c]++;
+                }
+            }
+
+            while (counts[c] < BATCH)
+            {
+                FreeNode *node = static_cast<FreeNode*>(malloc(sizeof(Header) + classSize(c)));
+                if (!node) break;
+
+                node->next = lists[c];
+                lists[c] = node;
+                counts[c]++;
+            }
+
+            return lists[c] ? 0 : -1;
+        }
+
+        /**
+         * Moves count blocks of a class to the depot.
+         */
+        void flush(int c, size_t count)
+        {
+            if (!count) return;
+
+            std::lock_guard<std::mutex> guard(depot.lock);
+
+            while (count-- && lists[c])
+            {
+                FreeNode *node = lists[c];
+                lists[c] = node->next;
+                node->next = depot.lists[c];
+                depot.lists[c] = node;
+                counts[c]--;
+            }
+        }
+    };
+
+    static Depot &depot()
+    {
+        static Depot instance;
+        return instance;
+    }
+
+    static ThreadCache &threadCache()
+    {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+};
+
+/**
+ * Allocator for DynArray that serves buffers from the SizeClassPool.
+ *
+ * Suits many small arrays built concurrently: the 8, 16, 32... element buffers of the default growth policy map to
+ * the power-of-two size classes and are recycled through lock-free per-thread free lists.
+ *
+ * @tparam T The element type. Must not need alignment stricter than 16 bytes.
+ */
+template <class T>
+struct PoolAlloc
+{
+    static_assert(alignof(T) <= sizeof(SizeClassPool::Header), "PoolAlloc supports up to 16 byte alignment.");
+
+    T *allocate(size_t n)
+    {
+        if (n > SIZE_MAX / sizeof(T)) return nullptr;
+        return static_cast<T*>(SizeClassPool::allocate(n * sizeof(T)));
+    }
+
+    T *reallocate(T *buf, size_t n)
+    {
+        if (n > SIZE_MAX / sizeof(T)) return nullptr;
+        return static_cast<T*>(SizeClassPool::reallocate(buf, n * sizeof(T)));
+    }
+
+    size_t usableSize(T *buf) {return SizeClassPool::usableSize(buf) / sizeof(T);}
+
+    void deallocate(T *buf) {SizeClassPool::deallocate(buf);}
+};
+
+#endif
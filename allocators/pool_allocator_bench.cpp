@@ -0,0 +1,75 @@
+#ifdef BENCHMARK
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <thread>
+
+#include "benchmark.h"
+#include "allocators/pool_allocator.h"
+#include "data_structures/dynamic_array.h"
+
+template <class T>
+struct Alloc
+{
+    T *allocate(size_t n) {return (T*)malloc(n * sizeof(T));}
+    T *reallocate(T* buf, size_t n) {return (T*)realloc(buf, n * sizeof(T)); }
+    void deallocate(T *buf) {free(buf);}
+};
+
+static const int ARRAYS = 1000;
+static const int ROUNDS = 200;
+
+/**
+ * Repeatedly builds a batch of small arrays of varying sizes and drops them.
+ */
+template <template <class> class A> static void worker(uint64_t *result)
+{
+    uint64_t sum = 0;
+
+    for (int round = 0; round < ROUNDS; round++)
+    {
+        DynArray<uint32_t, A<uint32_t>> *arrays = new DynArray<uint32_t, A<uint32_t>>[ARRAYS];
+
+        for (int i = 0; i < ARRAYS; i++)
+        {
+            int count = (i * 7 + round) % 60;
+            for (int j = 0; j < count; j++) arrays[i].add(j);
+            sum += arrays[i].getCount();
+        }
+
+        delete[] arrays;
+    }
+
+    *result = sum;
+}
+
+template <template <class> class A> static void benchThreads(const char *name, int threadCount)
+{
+    std::thread threads[16];
+    uint64_t results[16];
+
+    double start = benchNow();
+    for (int i = 0; i < threadCount; i++) threads[i] = std::thread(worker<A>, &results[i]);
+    for (int i = 0; i < threadCount; i++) threads[i].join();
+
+    benchReport(name, benchNow() - start, (size_t)threadCount * ARRAYS * ROUNDS);
+}
+
+int main()
+{
+    int counts[] = {1, 4, 16};
+    char name[64];
+
+    for (int threads : counts)
+    {
+        snprintf(name, sizeof(name), "%2d threads build small arrays, malloc", threads);
+        benchThreads<Alloc>(name, threads);
+        snprintf(name, sizeof(name), "%2d threads build small arrays, pool", threads);
+        benchThreads<PoolAlloc>(name, threads);
+    }
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <stddef.h>
+#include <stdio.h>
+#include <time.h>
+
+/**
+ * @returns A monotonic timestamp in seconds.
+ */
+static inline double benchNow()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * Makes the compiler believe the value is used, so the computation that produced it can't be optimized away.
+ */
+template <class T> static inline void benchKeep(const T &value)
+{
+    __asm__ __volatile__("" : : "r"(&value) : "memory");
+}
+
+/**
+ * Prints a result line.
+ *
+ * @param[in] name The name of the measurement.
+ * @param[in] seconds The elapsed time.
+ * @param[in] ops The number of operations performed in that time, used to calculate the time per operation.
+ */
+static inline void benchReport(const char *name, double seconds, size_t ops)
+{
+    printf("%-48s %10.3f ms %10.3f ns/op\n", name, seconds * 1e3, seconds * 1e9 / (ops ? ops : 1));
+}
+
+#endif
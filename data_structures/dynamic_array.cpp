@@ -1,7 +1,14 @@
 #ifdef UNIT_TEST
 #include <stdio.h>
 #include <stdlib.h>
+#include <malloc.h>
 #include <assert.h>
+#include <stdint.h>
+#include <math.h>
+
+#include <list>
+#include <sstream>
+#include <iterator>
 
 #include "dynamic_array.h"
 
@@ -9,15 +16,123 @@ template <class T>
 struct Alloc
 {
     T *allocate(size_t n) {return (T*)malloc(n * sizeof(T));}
-    T *reallocate(T* buf, size_t n) {return (T*)realloc(buf, n * sizeof(T)); }
+    T *reallocate(T* buf, size_t n) {return (T*)realloc((void*)buf, n * sizeof(T)); }
     void deallocate(T *buf) {free(buf);}
+    size_t usableSize(T *buf) {return malloc_usable_size(buf) / sizeof(T);}
 };
 
 template <class T>
 using List = DynArray<T, Alloc<T>>;
 
+/** Allocator that hands out buffers rounded up to 64 elements and counts the calls to reallocate. */
+template <class T>
+struct SlackAlloc
+{
+    static int reallocations;
+
+    static size_t roundUp(size_t n) {return (n + 63) / 64 * 64;}
+
+    T *allocate(size_t n) {return (T*)malloc(roundUp(n) * sizeof(T));}
+    T *reallocate(T* buf, size_t n) {reallocations++; return (T*)realloc(buf, roundUp(n) * sizeof(T)); }
+    void deallocate(T *buf) {free(buf);}
+    size_t usableSize(T *buf) {return malloc_usable_size(buf) / sizeof(T);}
+};
+
+template <class T> int SlackAlloc<T>::reallocations = 0;
+
+/** Bump allocator over a fixed region that can expand the most recent allocation in place. */
+template <class T>
+struct BumpAlloc
+{
+    static T region[256];
+    static size_t top;
+    static T *last;
+    static int expansions;
+    static int reallocations;
+
+    T *allocate(size_t n)
+    {
+        if (top + n > 256) return nullptr;
+        last = region + top;
+        top += n;
+        return last;
+    }
+
+    T *reallocate(T* buf, size_t n)
+    {
+        reallocations++;
+        T *newBuf = allocate(n);
+        if (newBuf && buf) memmove(newBuf, buf, n * sizeof(T)); // Reads past the old buffer but stays in the region.
+        return newBuf;
+    }
+
+    bool tryExpand(T *buf, size_t oldN, size_t newN)
+    {
+        if ((buf != last) || (buf + newN > region + 256)) return false;
+        top += newN - oldN;
+        expansions++;
+        return true;
+    }
+
+    void deallocate(T *) {}
+};
+
+template <class T> T BumpAlloc<T>::region[256];
+template <class T> size_t BumpAlloc<T>::top = 0;
+template <class T> T *BumpAlloc<T>::last = nullptr;
+template <class T> int BumpAlloc<T>::expansions = 0;
+template <class T> int BumpAlloc<T>::reallocations = 0;
+
 DynArrayError theError;
 
+/** Non-trivial element type that tracks the number of live instances. */
+struct Counted
+{
+    static int live;
+    static int copies;
+    int *value;
+
+    Counted(int x) : value(new int(x)) {live++;}
+    Counted(const Counted &other) : value(new int(*other.value)) {live++; copies++;}
+    Counted(Counted &&other) : value(other.value) {other.value = nullptr; live++;}
+    ~Counted() {delete value; live--;}
+
+    Counted& operator=(const Counted &other) {*value = *other.value; return *this;}
+    Counted& operator=(Counted &&other) {std::swap(value, other.value); return *this;}
+    bool operator==(const Counted &other) const {return *value == *other.value;}
+};
+
+int Counted::live = 0;
+int Counted::copies = 0;
+
+/** A class hierarchy, where pointers to the derived elements convert to pointers to the base. */
+// @{
+struct Base
+{
+    int value;
+};
+
+struct Derived : Base
+{
+    int extra;
+
+    Derived(int value, int extra) : Base{value}, extra(extra) {}
+};
+// @}
+
+/** Three way comparators for ints. */
+// @{
+struct Ascending
+{
+    int operator()(int a, int b) const {return (a > b) - (a < b);}
+};
+
+struct Descending
+{
+    int operator()(int a, int b) const {return (a < b) - (a > b);}
+};
+// @}
+
 void errorCallback(DynArrayError error, void *context)
 {
     theError = error;
@@ -238,6 +353,644 @@ int main()
     theError = DynArrayError::OK;
 
 
+    {
+        List<Counted> counted;
+
+        for (int i = 0; i < 100; i++)
+        {
+            assert(!counted.add(Counted(i)));
+        }
+        assert(Counted::live == 100);
+        assert(counted.getCount() == 100);
+        assert(*counted[0].value == 0);
+        assert(*counted[99].value == 99);
+
+        List<Counted> copy = counted;
+        assert(copy.isAlive());
+        assert(Counted::live == 200);
+        assert(copy.getCapacity() == 100);
+        assert(*copy[42].value == 42);
+
+        copy = counted;
+        assert(Counted::live == 200);
+
+        List<Counted> moved = static_cast<List<Counted>&&>(copy);
+        assert(Counted::live == 200);
+        assert(copy.getCount() == 0);
+        assert(moved.getCount() == 100);
+
+        assert(!counted.setCapacity(500));
+        assert(Counted::live == 200);
+        assert(*counted[99].value == 99);
+
+        List<Counted> range = counted.getRange(10, 5);
+        assert(Counted::live == 205);
+        assert(*range[0].value == 10);
+        assert(*range[4].value == 14);
+
+        counted.clear();
+        assert(Counted::live == 105);
+        assert(!counted.setCapacity(0));
+        assert(counted.getCapacity() == 0);
+    }
+    assert(Counted::live == 0);
+
+    {
+        List<int> emptyCopy = List<int>();
+        List<int> copyOfEmpty = emptyCopy;
+
+        assert(copyOfEmpty.isAlive());
+        assert(copyOfEmpty.getCount() == 0);
+        assert(!copyOfEmpty.add(7));
+        assert(copyOfEmpty[0] == 7);
+    }
+
+    assert(DynArrayDoublingGrowth::grow(0, 1, 4) == 8);
+    assert(DynArrayDoublingGrowth::grow(8, 9, 4) == 16);
+    assert(DynArrayDoublingGrowth::grow(8, 100, 4) == 128);
+    assert(DynArrayGoldenGrowth::grow(0, 1, 4) == 8);
+    assert(DynArrayGoldenGrowth::grow(8, 9, 4) == 12);
+    assert(DynArrayGoldenGrowth::grow(12, 13, 4) == 18);
+    assert(DynArrayLinearGrowth<64>::grow(0, 1, 4) == 16);
+    assert(DynArrayLinearGrowth<64>::grow(16, 17, 4) == 32);
+    assert(DynArrayLinearGrowth<64>::grow(16, 40, 4) == 48);
+    assert(DynArrayLinearGrowth<2>::grow(5, 6, 4) == 6);
+    assert(DynArraySizeClassGrowth<>::grow(0, 1, 4) == 8);
+    assert(DynArraySizeClassGrowth<>::grow(0, 1, 1) == 16);
+    assert(DynArraySizeClassGrowth<DynArrayLinearGrowth<1>>::grow(0, 5, 4) == 8); // 20 bytes -> 32 bytes class
+    assert(DynArraySizeClassGrowth<DynArrayLinearGrowth<1>>::grow(0, 3, 12) == 4); // 36 bytes -> 48 bytes class
+    assert(DynArraySizeClassGrowth<DynArrayLinearGrowth<1>>::grow(0, 7, 16) == 7); // 112 bytes is a class
+    assert(DynArraySizeClassGrowth<DynArrayGoldenGrowth>::grow(8, 9, 12) == 13); // 144 bytes -> 160 bytes class
+    assert(DynArraySizeClassGrowth<DynArrayGoldenGrowth>::grow(8, 9, 24) == 13); // 288 bytes -> 320 bytes class
+
+    {
+        DynArray<int, Alloc<int>, DynArrayLinearGrowth<40>> linear;
+
+        for (int i = 0; i < 25; i++)
+        {
+            assert(!linear.add(i));
+        }
+        assert(linear.getCapacity() == 30);
+        assert(linear[24] == 24);
+
+        DynArray<int, Alloc<int>, DynArrayLinearGrowth<40>> linearCopy = linear;
+        assert(linearCopy.getCount() == 25);
+
+        DynArray<int, Alloc<int>, DynArrayLinearGrowth<40>> odd = linear.findAll([](int x){return x % 2;});
+        assert(odd.getCount() == 12);
+    }
+
+    {
+        DynArray<int, SlackAlloc<int>> slack;
+
+        for (int i = 0; i < 64; i++)
+        {
+            assert(!slack.add(i));
+        }
+        assert(SlackAlloc<int>::reallocations == 1); // Plain doubling would need 8, 16, 32, 64.
+        assert(slack.getCapacity() >= 64);
+
+        while (slack.getCount() < slack.getCapacity())
+        {
+            assert(!slack.add(0));
+        }
+        assert(SlackAlloc<int>::reallocations == 1);
+        assert(!slack.add(0));
+        assert(SlackAlloc<int>::reallocations == 2);
+        assert(slack.getCapacity() >= 128);
+
+        assert(!slack.setCapacity(100));
+        assert(slack.getCapacity() == 100); // Explicit capacity requests are kept exact.
+    }
+
+    {
+        DynArray<int, BumpAlloc<int>> bump;
+
+        for (int i = 0; i < 64; i++)
+        {
+            assert(!bump.add(i));
+        }
+        assert(BumpAlloc<int>::reallocations == 1); // Only the first allocation.
+        assert(BumpAlloc<int>::expansions == 3); // 8 -> 16 -> 32 -> 64 in place.
+        assert(bump.begin() == BumpAlloc<int>::region);
+
+        DynArray<int, BumpAlloc<int>> other;
+        assert(!other.add(1));
+        assert(!other.add(2));
+
+        assert(!bump.add(64)); // No longer the last allocation, has to move.
+        assert(BumpAlloc<int>::reallocations == 3);
+        assert(BumpAlloc<int>::expansions == 3);
+        assert(bump[0] == 0);
+        assert(bump[64] == 64);
+    }
+
+    {
+        // Compile time error policies.
+        static_assert(sizeof(DynArray<int, Alloc<int>, DynArrayDoublingGrowth, DynArrayUnchecked>) + 16 ==
+            sizeof(List<int>), "Stateless policies should take no space.");
+
+        DynArray<int, Alloc<int>, DynArrayDoublingGrowth, DynArrayCallbackErrors<errorCallback>> fixedCb;
+        theError = DynArrayError::OK;
+        assert(!fixedCb.add(1));
+        fixedCb[1];
+        assert(theError == DynArrayError::INDEX_OUT_OF_RANGE);
+
+        theError = DynArrayError::OK;
+        DynArray<int, Alloc<int>, DynArrayDoublingGrowth, DynArrayCallbackErrors<errorCallback>> cbCopy(fixedCb);
+        assert(cbCopy.indexOf(1, 5, 1) == -1);
+        assert(theError == DynArrayError::INDEX_OUT_OF_RANGE);
+
+        DynArray<int, Alloc<int>, DynArrayDoublingGrowth, DynArrayIgnoreErrors> ignoring;
+        assert(!ignoring.add(1));
+        assert(ignoring.indexOf(1, 5, 1) == -1);
+        assert(ignoring.getRange(3, 1).getCount() == 0);
+
+        DynArray<int, Alloc<int>, DynArrayDoublingGrowth, DynArrayUnchecked> unchecked;
+        for (int i = 0; i < 10; i++)
+        {
+            assert(!unchecked.add(i));
+        }
+        assert(unchecked[9] == 9);
+        assert(unchecked.indexOf(9) == 9);
+        assert(unchecked.binarySearch(7));
+        assert(unchecked.getRange(2, 3)[2] == 4);
+
+        List<int> unset;
+        assert(unset.getErrorCb() != nullptr);
+        unset.getErrorCb()(DynArrayError::OK, nullptr); // The default callback can be called, it does nothing.
+        assert(unset.indexOf(1, 5, 1) == -1); // No callback set, nothing happens.
+        unset.setErrorCb(nullptr, nullptr);
+        assert(unset.getErrorCb() != nullptr);
+        assert(unset.indexOf(1, 5, 1) == -1);
+    }
+
+    {
+        // Bulk appends.
+        List<int> bulk;
+        bulk.setErrorCb(errorCallback, nullptr);
+
+        int values[] = {1, 2, 3, 4, 5};
+        assert(!bulk.addRange(values, values + 5));
+        assert(bulk.getCount() == 5);
+        assert(bulk[4] == 5);
+
+        assert(!bulk.addRange(bulk.begin(), bulk.end())); // Aliasing range, forces growth.
+        assert(bulk.getCount() == 10);
+        assert(bulk[5] == 1);
+        assert(bulk[9] == 5);
+
+        std::list<int> linked = {7, 8, 9};
+        assert(!bulk.addRange(linked.begin(), linked.end()));
+        assert(bulk.getCount() == 13);
+        assert(bulk[12] == 9);
+
+        assert(!bulk.addRange(values, values));
+        assert(bulk.getCount() == 13);
+
+        // Pointers to derived elements are sliced one by one, not block copied with the size of the base.
+        Derived derived[] = {Derived(1, 100), Derived(2, 200), Derived(3, 300)};
+        List<Base> bases;
+
+        assert(!bases.addRange(derived, derived + 3));
+        assert(bases.getCount() == 3);
+        for (int i = 0; i < 3; i++) assert(bases[i].value == i + 1);
+
+        assert(!bulk.addN(100, bulk[0])); // Aliasing value.
+        assert(bulk.getCount() == 113);
+        assert(bulk[112] == 1);
+
+        theError = DynArrayError::OK;
+        assert(bulk.addN(SIZE_MAX, 0));
+        assert(theError == DynArrayError::ALLOCATION_FAILURE);
+        assert(bulk.getCount() == 113);
+
+        int *raw = bulk.appendUninitialized(3);
+        assert(raw);
+        raw[0] = 10;
+        raw[1] = 11;
+        assert(bulk.getCount() == 116);
+        bulk.truncate(115);
+        assert(bulk.getCount() == 115);
+        assert(bulk[114] == 11);
+
+        theError = DynArrayError::OK;
+        assert(!bulk.appendUninitialized(SIZE_MAX / 2));
+        assert(theError == DynArrayError::ALLOCATION_FAILURE);
+        assert(bulk.getCount() == 115);
+
+        Counted::live = 0;
+        {
+            List<Counted> counted;
+            Counted seed[] = {Counted(1), Counted(2)};
+
+            assert(!counted.addRange(seed, seed + 2));
+            assert(!counted.addN(3, seed[1]));
+            assert(!counted.addRange(counted.begin(), counted.end()));
+            assert(counted.getCount() == 10);
+            assert(*counted[9].value == 2);
+            assert(Counted::live == 12);
+
+            counted.truncate(4);
+            assert(Counted::live == 6);
+        }
+        assert(Counted::live == 0);
+    }
+
+    {
+        // Move aware insertion.
+        static_assert(DynArrayTriviallyRelocatable<List<Counted>>::value, "Plain arrays relocate with memcpy.");
+
+        Counted::live = 0;
+        Counted::copies = 0;
+        {
+            List<List<Counted>> nested;
+
+            for (int i = 0; i < 100; i++)
+            {
+                List<Counted> inner;
+
+                assert(!inner.add(Counted(i)));
+                assert(!inner.emplace(i + 1));
+                assert(!nested.add(static_cast<List<Counted>&&>(inner)));
+                assert(inner.getCount() == 0);
+            }
+            assert(!nested.emplace());
+
+            assert(nested.getCount() == 101);
+            assert(*nested[99][1].value == 100);
+            assert(nested[100].getCount() == 0);
+            assert(Counted::copies == 0);
+            assert(Counted::live == 200);
+
+            List<Counted> grow;
+            do
+            {
+                assert(!grow.emplace(1));
+            } while (grow.getCount() < grow.getCapacity());
+            assert(!grow.add(grow[0])); // Aliasing element while growing.
+            assert(*grow[1].value == 1);
+        }
+        assert(Counted::live == 0);
+    }
+
+    {
+        // Positional insert and remove.
+        List<int> pos;
+        pos.setErrorCb(errorCallback, nullptr);
+
+        for (int i = 0; i < 10; i++) assert(!pos.add(i));
+
+        assert(!pos.insertAt(0, -1));
+        assert(!pos.insertAt(5, pos[10])); // Aliasing element, 9.
+        assert(!pos.insertAt(pos.getCount(), 100));
+        int expected1[] = {-1, 0, 1, 2, 3, 9, 4, 5, 6, 7, 8, 9, 100};
+        assert(pos.getCount() == 13);
+        for (size_t i = 0; i < pos.getCount(); i++) assert(pos[i] == expected1[i]);
+
+        theError = DynArrayError::OK;
+        assert(pos.insertAt(14, 0));
+        assert(theError == DynArrayError::INDEX_OUT_OF_RANGE);
+
+        assert(!pos.removeAt(0));
+        assert(!pos.removeRange(4, 1));
+        assert(!pos.removeRange(pos.getCount() - 1, 1));
+        assert(!pos.removeRange(pos.getCount(), 0));
+        assert(pos.getCount() == 10);
+        for (int i = 0; i < 10; i++) assert(pos[i] == i);
+
+        theError = DynArrayError::OK;
+        assert(pos.removeRange(5, 6));
+        assert(theError == DynArrayError::INDEX_OUT_OF_RANGE);
+        theError = DynArrayError::OK;
+        assert(pos.removeRange(11, 0));
+        assert(theError == DynArrayError::INDEX_OUT_OF_RANGE);
+
+        int extra[] = {20, 21, 22};
+        assert(!pos.insertRange(2, extra, extra + 3));
+        assert(pos.getCount() == 13);
+        assert(pos[1] == 1 && pos[2] == 20 && pos[4] == 22 && pos[5] == 2);
+        assert(!pos.removeRange(2, 3));
+
+        // Aliasing range that straddles the insertion point: 3 4 5 6 inserted before 5.
+        assert(!pos.insertRange(5, pos.begin() + 3, pos.begin() + 7));
+        int expected2[] = {0, 1, 2, 3, 4, 3, 4, 5, 6, 5, 6, 7, 8, 9};
+        assert(pos.getCount() == 14);
+        for (size_t i = 0; i < pos.getCount(); i++) assert(pos[i] == expected2[i]);
+        assert(!pos.removeRange(5, 4));
+
+        std::list<int> linked = {30, 31};
+        assert(!pos.insertRange(1, linked.begin(), linked.end()));
+        assert(pos[0] == 0 && pos[1] == 30 && pos[2] == 31 && pos[3] == 1);
+        assert(!pos.removeRange(1, 2));
+
+        Derived derived[] = {Derived(1, 100), Derived(2, 200), Derived(3, 300)};
+        List<Base> bases;
+
+        assert(!bases.add(Base{9}));
+        assert(!bases.insertRange(0, derived, derived + 3));
+        assert(bases.getCount() == 4);
+        for (int i = 0; i < 3; i++) assert(bases[i].value == i + 1);
+        assert(bases[3].value == 9);
+
+        std::istringstream stream("40 41 42");
+        assert(!pos.insertRange(9, std::istream_iterator<int>(stream), std::istream_iterator<int>()));
+        assert(pos.getCount() == 13);
+        assert(pos[8] == 8 && pos[9] == 40 && pos[11] == 42 && pos[12] == 9);
+        assert(!pos.removeRange(9, 3));
+
+        assert(!pos.swapRemove(2));
+        assert(pos[2] == 9);
+        assert(pos.getCount() == 9);
+        assert(!pos.swapRemove(8));
+        assert(pos.getCount() == 8);
+        assert(pos[7] == 7);
+
+        Counted::live = 0;
+        {
+            List<Counted> counted;
+
+            for (int i = 0; i < 8; i++) assert(!counted.add(Counted(i)));
+            assert(!counted.insertAt(3, counted[7]));
+            assert(!counted.emplaceAt(0, 42));
+            assert(!counted.insertRange(2, counted.begin(), counted.begin() + 4));
+            assert(counted.getCount() == 14);
+            int expected3[] = {42, 0, 42, 0, 1, 2, 1, 2, 7, 3, 4, 5, 6, 7};
+            for (size_t i = 0; i < counted.getCount(); i++) assert(*counted[i].value == expected3[i]);
+            assert(Counted::live == 14);
+
+            assert(!counted.removeRange(2, 4));
+            assert(!counted.removeAt(0));
+            assert(!counted.swapRemove(0));
+            assert(counted.getCount() == 8);
+            assert(*counted[0].value == 7);
+            assert(*counted[1].value == 1);
+            assert(Counted::live == 8);
+        }
+        assert(Counted::live == 0);
+    }
+
+    {
+        // In place filtering.
+        List<int> filtered;
+
+        for (int i = 0; i < 1000; i++) assert(!filtered.add(i));
+
+        assert(filtered.removeIf([](int x) {return x % 3 == 0;}) == 334);
+        assert(filtered.getCount() == 666);
+        assert(filtered[0] == 1 && filtered[1] == 2 && filtered[2] == 4 && filtered[665] == 998);
+
+        assert(filtered.retainIf([](int x) {return x < 10;}) == 660);
+        int expected[] = {1, 2, 4, 5, 7, 8};
+        for (size_t i = 0; i < filtered.getCount(); i++) assert(filtered[i] == expected[i]);
+
+        assert(filtered.removeIf([](int) {return false;}) == 0);
+        assert(filtered.removeIf([](int) {return true;}) == 6);
+        assert(filtered.getCount() == 0);
+        assert(filtered.removeIf([](int) {return true;}) == 0);
+
+        Counted::live = 0;
+        {
+            List<Counted> counted;
+            int calls = 0;
+
+            for (int i = 0; i < 20; i++) assert(!counted.add(Counted(i)));
+
+            assert(counted.removeIf([&calls](const Counted &c) {calls++; return *c.value % 2 == 1;}) == 10);
+            assert(calls == 20);
+            assert(Counted::live == 10);
+            for (size_t i = 0; i < counted.getCount(); i++) assert(*counted[i].value == (int)i * 2);
+
+            assert(counted.retainIf([](const Counted &c) {return *c.value >= 10;}) == 5);
+            assert(*counted[0].value == 10);
+            assert(Counted::live == 5);
+        }
+        assert(Counted::live == 0);
+    }
+
+    {
+        // Equality searches.
+        List<int> searched;
+        searched.setErrorCb(errorCallback, nullptr);
+
+        for (int i = 0; i < 1000; i++) assert(!searched.add(i % 100));
+
+        assert(searched.indexOf(42) == 42);
+        assert(searched.indexOf(42, 43) == 142);
+        assert(searched.indexOf(42, 143, 50) == -1);
+        assert(searched.lastIndexOf(42) == 942);
+        assert(searched.lastIndexOf(42, 0, 942) == 842);
+        assert(searched.lastIndexOf(100) == -1);
+        assert(searched.contains(99));
+        assert(!searched.contains(-1));
+
+        assert(searched.findIndex(simdEq(7)) == 7);
+        assert(searched.findIndex(500, simdEq(7)) == 507);
+        assert(searched.findLastIndex(simdEq(7)) == 907);
+        assert(searched.findLastIndex(0, 900, simdEq(7)) == 807);
+        assert(searched.findLastIndex(300, 5, simdEq(7)) == -1); // Stays in the range.
+        assert(searched.findLastIndex(300, 5, [](int x) {return x == 7;}) == -1);
+        assert(searched.findLastIndex(300, 10, [](int x) {return x == 7;}) == 307);
+
+        theError = DynArrayError::OK;
+        assert(searched.lastIndexOf(1, 990, 11) == -1);
+        assert(theError == DynArrayError::INDEX_OUT_OF_RANGE);
+
+        List<double> doubles;
+        assert(!doubles.contains(1.0));
+        assert(!doubles.add(1.5));
+        assert(!doubles.add(-0.0));
+        assert(doubles.indexOf(0.0) == 1);
+    }
+
+    {
+        // Vectorized predicates.
+        List<int> numbers;
+        numbers.setErrorCb(errorCallback, nullptr);
+
+        for (int i = 0; i < 10000; i++) assert(!numbers.add(i % 1000 - 500));
+
+        assert(numbers.exists(simdBetween(100, 101)));
+        assert(!numbers.exists(simdGt(499)));
+        assert(numbers.findIndex(simdOr(simdLt(-499), simdGt(498))) == 0);
+        assert(numbers.findLastIndex(simdInSet(-1, 1)) == 9501);
+
+        List<int> found = numbers.findAll(simdAnd(simdGt(-10), simdNot(simdGt(10))));
+        assert(found.getCount() == 200);
+        for (size_t i = 0; i < found.getCount(); i++) assert(found[i] == (int)(i % 20) - 9);
+
+        assert(numbers.removeIf(simdLt(0)) == 5000);
+        for (size_t i = 0; i < numbers.getCount(); i++) assert(numbers[i] == (int)(i % 500));
+
+        assert(numbers.retainIf(simdBetween(100, 199)) == 4000);
+        for (size_t i = 0; i < numbers.getCount(); i++) assert(numbers[i] == (int)(i % 100) + 100);
+
+        List<float> floats;
+        assert(!floats.add(1.0f));
+        assert(!floats.add(NAN));
+        assert(!floats.add(-2.0f));
+        assert(floats.retainIf(simdBetween(-INFINITY, INFINITY)) == 1);
+        assert(floats.getCount() == 2);
+        assert(floats[1] == -2.0f);
+    }
+
+    {
+        // Binary search, compared with a linear scan over every subrange of sorted arrays with duplicates.
+        List<int> ascending;
+        List<int> descending;
+        ascending.setErrorCb(errorCallback, nullptr);
+
+        for (int i = 0; i < 40; i++)
+        {
+            assert(!ascending.add(i / 3 * 2));
+            assert(!descending.add(-(i / 3 * 2)));
+        }
+
+        theError = DynArrayError::OK;
+        for (size_t start = 0; start <= 40; start++)
+        {
+            for (size_t length = 0; start + length <= 40; length++)
+            {
+                for (int key = -1; key <= 27; key++)
+                {
+                    bool expected = false;
+
+                    for (size_t i = start; i < start + length; i++) expected |= (ascending[i] == key);
+
+                    assert(ascending.binarySearch<Ascending>(start, length, key) == expected);
+                    assert(descending.binarySearch<Descending>(start, length, -key) == expected);
+
+                    size_t lower = start;
+                    while ((lower < start + length) && (ascending[lower] < key)) lower++;
+                    size_t upper = lower;
+                    while ((upper < start + length) && (ascending[upper] == key)) upper++;
+
+                    assert(ascending.lowerBound<Ascending>(start, length, key) == (ssize_t)lower);
+                    assert(ascending.upperBound<Ascending>(start, length, key) == (ssize_t)upper);
+                    assert(descending.lowerBound<Descending>(start, length, -key) == (ssize_t)lower);
+                    assert(descending.upperBound<Descending>(start, length, -key) == (ssize_t)upper);
+                    assert(ascending.equalRange<Ascending>(start, length, key) == std::make_pair((ssize_t)lower, (ssize_t)upper));
+                }
+            }
+        }
+        assert(theError == DynArrayError::OK); // Empty ranges, even at the end, are valid.
+
+        assert(!ascending.binarySearch<Ascending>(40, 1, 0));
+        assert(theError == DynArrayError::INDEX_OUT_OF_RANGE);
+        theError = DynArrayError::OK;
+        assert(!ascending.binarySearch<Ascending>(1, SIZE_MAX, 0));
+        assert(theError == DynArrayError::INDEX_OUT_OF_RANGE);
+        theError = DynArrayError::OK;
+
+        assert(ascending.lowerBound(4) == 6);
+        assert(ascending.upperBound(4) == 9);
+        assert(ascending.equalRange(5) == std::make_pair((ssize_t)9, (ssize_t)9));
+        assert(ascending.lowerBound(100) == 40);
+        assert(ascending.upperBound<Ascending>(-1) == 0);
+        assert(ascending.equalRange<Ascending>(26) == std::make_pair((ssize_t)39, (ssize_t)40));
+
+        assert(ascending.lowerBound<Ascending>(41, 0, 0) == -1);
+        assert(theError == DynArrayError::INDEX_OUT_OF_RANGE);
+        theError = DynArrayError::OK;
+        assert(ascending.equalRange<Ascending>(10, 31, 0) == std::make_pair((ssize_t)-1, (ssize_t)-1));
+        assert(theError == DynArrayError::INDEX_OUT_OF_RANGE);
+        theError = DynArrayError::OK;
+
+        // Batches of every size around the group size against single searches, on arrays of each length.
+        static int keys[100];
+        static bool found[100];
+        static ssize_t indices[100];
+
+        for (int i = 0; i < 100; i++) keys[i] = (i * 37) % 31 - 2;
+
+        for (size_t length = 0; length <= 40; length++)
+        {
+            List<int> prefix = ascending.getRange(0, length);
+
+            for (size_t count = 0; count <= 100; count += (count < 40 ? 1 : 20))
+            {
+                prefix.binarySearchBatch(keys, count, found);
+                prefix.lowerBoundBatch<Ascending>(keys, count, indices);
+
+                for (size_t i = 0; i < count; i++)
+                {
+                    assert(found[i] == prefix.binarySearch(keys[i]));
+                    assert(indices[i] == prefix.lowerBound(keys[i]));
+                }
+            }
+        }
+
+        List<int> empty;
+        empty.setErrorCb(errorCallback, nullptr);
+        assert(!empty.binarySearch(0));
+        assert(empty.lowerBound(0) == 0);
+        assert(empty.equalRange(0) == std::make_pair((ssize_t)0, (ssize_t)0));
+        assert(theError == DynArrayError::OK);
+    }
+
+    {
+        // Sorting.
+        List<int> list;
+        list.setErrorCb(errorCallback, nullptr);
+
+        for (int i = 0; i < 1000; i++) assert(!list.add((i * 7919) % 1000 / 2));
+
+        list.sort();
+        for (int i = 0; i < 1000; i++) assert(list[i] == i / 2);
+        assert(list.binarySearch(250));
+
+        list.sort<Descending>();
+        for (int i = 0; i < 1000; i++) assert(list[i] == (999 - i) / 2);
+
+        assert(!list.sort<Ascending>(100, 50));
+        for (int i = 0; i < 50; i++) assert(list[100 + i] == (899 - 49 + i) / 2);
+        assert(list[99] == 450);
+        assert(list[150] == 424);
+
+        theError = DynArrayError::OK;
+        assert(list.sort<Ascending>(900, 101));
+        assert(theError == DynArrayError::INDEX_OUT_OF_RANGE);
+        theError = DynArrayError::OK;
+        assert(list.stableSort<Ascending>(1001, 0));
+        assert(theError == DynArrayError::INDEX_OUT_OF_RANGE);
+        theError = DynArrayError::OK;
+
+        // Stable sort of non-trivial elements by the tens digit only, the units must stay in their original order.
+        struct ByTens
+        {
+            int operator()(const Counted &a, const Counted &b) const {return *a.value / 10 - *b.value / 10;}
+        };
+
+        {
+            DynArray<Counted, Alloc<Counted>> counted;
+
+            for (int i = 0; i < 500; i++) assert(!counted.add(Counted((i * 37) % 50 * 10 + i / 50)));
+
+            counted.stableSort<ByTens>();
+            for (int i = 0; i < 500; i++) assert(*counted[i].value == i / 10 * 10 + i % 10);
+            assert(Counted::live == 500);
+
+            counted.sort<ByTens>();
+            for (int i = 0; i < 500; i++) assert(*counted[i].value / 10 == i / 10);
+            assert(Counted::live == 500);
+        }
+        assert(Counted::live == 0);
+
+        // The bump region is full, so the stable sort merges in place.
+        DynArray<uint16_t, BumpAlloc<uint16_t>> full;
+
+        for (int i = 0; i < 256; i++) assert(!full.add((uint16_t)((i * 37) % 64 * 256 + i)));
+        assert(full.getCapacity() == 256);
+
+        struct HighByte
+        {
+            int operator()(uint16_t a, uint16_t b) const {return (a >> 8) - (b >> 8);}
+        };
+
+        full.stableSort<HighByte>();
+        for (int i = 0; i < 256; i++) assert(full[i] >> 8 == i / 4);
+        for (int i = 1; i < 256; i++) assert((i % 4 == 0) || ((full[i - 1] & 255) < (full[i] & 255)));
+    }
 
     printf("Passed: %s %s\n", __DATE__, __TIME__);
 
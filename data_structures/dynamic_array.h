@@ -1,4 +1,20 @@
+#ifndef DYNAMIC_ARRAY_H
+#define DYNAMIC_ARRAY_H
+
 #include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "simd_predicates.h"
+#include "sort.h"
 
 /** This enum contains the possible errors in this class. */
 enum class DynArrayError
@@ -6,390 +22,1815 @@ enum class DynArrayError
     OK, ///< Everything is alright
     ALLOCATION_FAILURE, ///< Indicates memory allocation failure
     INDEX_OUT_OF_RANGE, ///< Index out of range when attempted to access the array.
-    INVALID_CAPACITY ///< Wrong capacity provided when attempted to resize the object.
+    INVALID_CAPACITY, ///< Wrong capacity provided when attempted to resize the object.
+    CAPACITY_EXCEEDED ///< Attempted to add more elements than a fixed capacity array can hold.
+};
+
+typedef void (*DynArrayErrorCallback)(DynArrayError error, void *context);
+
+/**
+ * Error policies.
+ *
+ * The array inherits from its error policy, which decides what happens on errors at compile time. A policy must
+ * provide:
+ *
+ *   static const bool checkBounds;
+ *
+ * Whether the index and range arguments are validated. Without it out of range access is undefined behavior.
+ *
+ *   void reportError(DynArrayError error) const;
+ *
+ * Called on every error. Functions still return their failure value afterwards.
+ *
+ * Stateless policies take no space in the array and let the compiler inline the whole access path.
+ */
+// @{
+
+/**
+ * Calls a callback set at runtime through a function pointer stored in the array. This is the default.
+ *
+ * @remarks
+ *  Also provides getErrorCb, getErrorCbCtx and setErrorCb. The default callback ignores the errors, setting a
+ *  nullptr callback restores it, so getErrorCb never returns nullptr and the callback can always be called.
+ */
+class DynArrayRuntimeErrors
+{
+    DynArrayErrorCallback errorCb; ///< The callback.
+    void *errorCbCtx; ///< The context passed to the callback.
+
+    static void ignoreError(DynArrayError, void*) {}
+
+public:
+    static const bool checkBounds = true;
+
+    constexpr DynArrayRuntimeErrors() : errorCb(ignoreError), errorCbCtx(nullptr) {}
+
+    void reportError(DynArrayError error) const
+    {
+        errorCb(error, errorCbCtx);
+    }
+
+    DynArrayErrorCallback getErrorCb() const {return errorCb;}
+    void* getErrorCbCtx() const {return errorCbCtx;}
+    void setErrorCb(DynArrayErrorCallback ecb, void *ctx) {errorCb = ecb ? ecb : ignoreError; errorCbCtx = ctx;}
+};
+
+/**
+ * Calls a callback chosen at compile time. The context argument is always nullptr.
+ *
+ * @tparam Callback The function to call.
+ */
+template <DynArrayErrorCallback Callback>
+struct DynArrayCallbackErrors
+{
+    static const bool checkBounds = true;
+
+    static void reportError(DynArrayError error) {Callback(error, nullptr);}
+};
+
+/**
+ * Aborts the program on any error.
+ */
+struct DynArrayAbortOnError
+{
+    static const bool checkBounds = true;
+
+    static void reportError(DynArrayError) {abort();}
+};
+
+/**
+ * Checks arguments, but doesn't report errors. The failure return values are still returned.
+ */
+struct DynArrayIgnoreErrors
+{
+    static const bool checkBounds = true;
+
+    static void reportError(DynArrayError) {}
+};
+
+/**
+ * Skips bounds checks and ignores errors, for release builds of well tested code.
+ *
+ * Out of range indexes are undefined behavior, like with a plain C array. Allocation failures are still detected and
+ * returned.
+ */
+struct DynArrayUnchecked
+{
+    static const bool checkBounds = false;
+
+    static void reportError(DynArrayError) {}
+};
+
+// @}
+
+/**
+ * Tells whether T can be moved to a different address with a plain memcpy.
+ *
+ * Such types are grown with the allocator's reallocate, everything else is move constructed into a fresh buffer
+ * and the old elements are destroyed.
+ *
+ * @remarks
+ *  Defaults to std::is_trivially_copyable. Specialize it to std::true_type for types that don't hold pointers
+ *  into themselves (e.g. a type that only owns a heap pointer) to make them use the fast path.
+ */
+template <class T>
+struct DynArrayTriviallyRelocatable : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
+/**
+ * Element lifetime helpers used by DynArray.
+ *
+ * The implementation is chosen at compile time based on the traits of T: trivial types are handled with memcpy
+ * and no-op destruction, other types are copy/move constructed and destroyed one by one.
+ */
+template <class T>
+struct DynArrayRelocator
+{
+    typedef std::integral_constant<bool, std::is_trivially_copyable<T>::value> TriviallyCopyable;
+    typedef std::integral_constant<bool, std::is_trivially_destructible<T>::value> TriviallyDestructible;
+    typedef std::integral_constant<bool, DynArrayTriviallyRelocatable<T>::value> TriviallyRelocatable;
+
+    /**
+     * Copy constructs count elements from src into the uninitialized dst.
+     */
+    static void copy(T *dst, const T *src, size_t count) {copy(dst, src, count, TriviallyCopyable());}
+
+    /**
+     * Moves count elements from src into the uninitialized dst. The source elements are destroyed.
+     */
+    static void relocate(T *dst, T *src, size_t count) {relocate(dst, src, count, TriviallyRelocatable());}
+
+    /**
+     * Destroys count elements starting at buf.
+     */
+    static void destroy(T *buf, size_t count) {destroy(buf, count, TriviallyDestructible());}
+
+    /**
+     * Moves count elements from src to dst within the same buffer, the ranges may overlap. The source elements that
+     * are not overwritten are destroyed.
+     */
+    static void relocateOverlapping(T *dst, T *src, size_t count)
+    {
+        relocateOverlapping(dst, src, count, TriviallyRelocatable());
+    }
+
+private:
+    static void copy(T *dst, const T *src, size_t count, std::true_type)
+    {
+        if (count) memcpy(static_cast<void*>(dst), src, count * sizeof(T));
+    }
+
+    static void copy(T *dst, const T *src, size_t count, std::false_type)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            new (dst + i) T(src[i]);
+        }
+    }
+
+    static void relocate(T *dst, T *src, size_t count, std::true_type)
+    {
+        if (count) memcpy(static_cast<void*>(dst), static_cast<void*>(src), count * sizeof(T));
+    }
+
+    static void relocate(T *dst, T *src, size_t count, std::false_type)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            new (dst + i) T(static_cast<T&&>(src[i]));
+            src[i].~T();
+        }
+    }
+
+    static void relocateOverlapping(T *dst, T *src, size_t count, std::true_type)
+    {
+        if (count) memmove(static_cast<void*>(dst), static_cast<void*>(src), count * sizeof(T));
+    }
+
+    static void relocateOverlapping(T *dst, T *src, size_t count, std::false_type)
+    {
+        if (dst < src)
+        {
+            relocate(dst, src, count, std::false_type());
+            return;
+        }
+
+        for (size_t i = count; i --> 0;)
+        {
+            new (dst + i) T(static_cast<T&&>(src[i]));
+            src[i].~T();
+        }
+    }
+
+    static void destroy(T *, size_t, std::true_type) {}
+
+    static void destroy(T *buf, size_t count, std::false_type)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            buf[i].~T();
+        }
+    }
+};
+
+/**
+ * Detects the optional parts of the allocator interface.
+ *
+ * Besides the mandatory allocate, reallocate and deallocate an allocator may provide:
+ *
+ *   size_t usableSize(T *buf);
+ *
+ * Which returns the number of elements that actually fit into the buffer. The array uses the extra space the
+ * allocator handed back as capacity when it grows.
+ *
+ *   bool tryExpand(T *buf, size_t oldN, size_t newN);
+ *
+ * Which grows the buffer to newN elements without moving it and returns true, or returns false and leaves the
+ * buffer untouched. The array tries this before reallocating, which works for any element type as nothing moves.
+ *
+ *   static const size_t alignment;
+ *
+ * The alignment in bytes every buffer (including reallocated ones) is guaranteed to have.
+ *
+ *   bool isInline(const T *buf) const;
+ *
+ * Which returns true if the buffer is stored inside the allocator object itself. Such buffers can't be handed over
+ * to another array on move, the elements are moved instead.
+ */
+template <class T, class Alloc>
+struct DynArrayAllocTraits
+{
+private:
+    template <class A> static auto testUsableSize(int)
+        -> decltype(std::declval<A&>().usableSize(static_cast<T*>(nullptr)), std::true_type());
+    template <class A> static std::false_type testUsableSize(...);
+
+    template <class A> static auto testTryExpand(int)
+        -> decltype(static_cast<bool>(std::declval<A&>().tryExpand(static_cast<T*>(nullptr), size_t(), size_t())),
+            std::true_type());
+    template <class A> static std::false_type testTryExpand(...);
+
+    template <class A> static auto testIsInline(int)
+        -> decltype(static_cast<bool>(std::declval<const A&>().isInline(static_cast<const T*>(nullptr))),
+            std::true_type());
+    template <class A> static std::false_type testIsInline(...);
+
+    template <class A> static std::integral_constant<size_t, A::alignment> testAlignment(int);
+    template <class A> static std::integral_constant<size_t, alignof(T)> testAlignment(...);
+
+    static size_t usableSize(Alloc &ator, T *buf, size_t requested, std::true_type)
+    {
+        size_t usable = ator.usableSize(buf);
+        return usable > requested ? usable : requested;
+    }
+
+    static size_t usableSize(Alloc &, T *, size_t requested, std::false_type) {return requested;}
+
+    static bool tryExpand(Alloc &ator, T *buf, size_t oldN, size_t newN, std::true_type)
+    {
+        return ator.tryExpand(buf, oldN, newN);
+    }
+
+    static bool tryExpand(Alloc &, T *, size_t, size_t, std::false_type) {return false;}
+
+    static bool isInline(const Alloc &ator, const T *buf, std::true_type) {return ator.isInline(buf);}
+    static bool isInline(const Alloc &, const T *, std::false_type) {return false;}
+
+public:
+    typedef decltype(testUsableSize<Alloc>(0)) HasUsableSize;
+    typedef decltype(testTryExpand<Alloc>(0)) HasTryExpand;
+    typedef decltype(testIsInline<Alloc>(0)) HasIsInline;
+
+    /**
+     * The guaranteed alignment of the buffers in bytes. alignof(T) if the allocator doesn't tell.
+     */
+    static const size_t alignment = decltype(testAlignment<Alloc>(0))::value;
+
+    /**
+     * @returns The number of elements the buffer can hold. At least requested.
+     */
+    static size_t usableSize(Alloc &ator, T *buf, size_t requested)
+    {
+        return usableSize(ator, buf, requested, HasUsableSize());
+    }
+
+    /**
+     * Attempts to grow the buffer without moving it.
+     *
+     * @returns True if the buffer now holds newN elements. Always false if the allocator can't expand in place.
+     */
+    static bool tryExpand(Alloc &ator, T *buf, size_t oldN, size_t newN)
+    {
+        return tryExpand(ator, buf, oldN, newN, HasTryExpand());
+    }
+
+    /**
+     * @returns True if the buffer is stored inside the allocator object.
+     */
+    static bool isInline(const Alloc &ator, const T *buf)
+    {
+        return isInline(ator, buf, HasIsInline());
+    }
+};
+
+/**
+ * Growth policies.
+ *
+ * A growth policy decides the new capacity when the array runs out of space. It must provide the following
+ * static function:
+ *
+ *   size_t grow(size_t capacity, size_t required, size_t elemSize);
+ *
+ * Which returns the new capacity (at least required elements) given the current capacity and the size of an
+ * element in bytes.
+ */
+// @{
+
+/**
+ * Starts at 8 elements and doubles the capacity. This is the default.
+ */
+struct DynArrayDoublingGrowth
+{
+    static size_t grow(size_t capacity, size_t required, size_t elemSize)
+    {
+        size_t newCapacity = capacity ? capacity : 8;
+
+        while (newCapacity < required)
+        {
+            if (newCapacity > SIZE_MAX / 2 / elemSize) return required;
+            newCapacity *= 2;
+        }
+
+        return newCapacity;
+    }
+};
+
+/**
+ * Starts at 8 elements and grows by 1.5x, close to the golden ratio.
+ *
+ * Trades more reallocations for less unused capacity. Also allows the allocator to reuse the previously freed
+ * blocks for the next growth step.
+ */
+struct DynArrayGoldenGrowth
+{
+    static size_t grow(size_t capacity, size_t required, size_t elemSize)
+    {
+        size_t newCapacity = capacity ? capacity : 8;
+
+        while (newCapacity < required)
+        {
+            if (newCapacity > SIZE_MAX / 2 / elemSize) return required;
+            newCapacity += newCapacity / 2;
+        }
+
+        return newCapacity;
+    }
+};
+
+/**
+ * Grows the buffer by fixed size chunks.
+ *
+ * The unused capacity is bounded by the chunk size, which matters when the array is comparable in size to the
+ * available memory. The number of reallocations grows linearly though, so this is best paired with an allocator
+ * that can grow in place.
+ *
+ * @tparam ChunkBytes The size of a chunk in bytes. At least one element is added per growth.
+ */
+template <size_t ChunkBytes>
+struct DynArrayLinearGrowth
+{
+    static size_t grow(size_t capacity, size_t required, size_t elemSize)
+    {
+        size_t chunk = ChunkBytes / elemSize;
+
+        if (chunk == 0) chunk = 1;
+        if (capacity < required) capacity = required;
+
+        size_t rem = capacity % chunk;
+        if ((rem != 0) && (capacity <= SIZE_MAX / elemSize - chunk)) capacity += chunk - rem;
+
+        return capacity;
+    }
+};
+
+/**
+ * Rounds the capacity computed by another policy up so the buffer fills a whole malloc size class.
+ *
+ * The size classes follow jemalloc's: multiples of 16 bytes up to 128 bytes, then four classes for each power of two.
+ * Memory the allocator would round up anyway becomes capacity instead of slack.
+ *
+ * @tparam BasePolicy The policy that computes the capacity before rounding.
+ */
+template <class BasePolicy = DynArrayDoublingGrowth>
+struct DynArraySizeClassGrowth
+{
+    static size_t grow(size_t capacity, size_t required, size_t elemSize)
+    {
+        size_t newCapacity = BasePolicy::grow(capacity, required, elemSize);
+
+        if (newCapacity > SIZE_MAX / 2 / elemSize) return newCapacity;
+
+        size_t bytes = newCapacity * elemSize;
+        size_t sizeClass = 16;
+
+        if (bytes > sizeClass)
+        {
+            size_t pow2 = 16;
+
+            while (pow2 * 2 < bytes) pow2 *= 2;
+
+            size_t step = pow2 / 4 < 16 ? 16 : pow2 / 4; // The small classes are 16 bytes apart.
+            sizeClass = (bytes + step - 1) / step * step;
+        }
+
+        return sizeClass / elemSize;
+    }
+};
+
+// @}
+
+
+/**
+ * Three way comparator using the == and < operators of T, for the search functions without a Compare argument.
+ */
+template <class T>
+struct DynArrayCompare
+{
+    int operator()(const T &a, const T &b) const
+    {
+        // Testing < first lets the compiler reduce compare(a, b) < 0 to a < b, also for floating point numbers.
+        if (a < b) return -1;
+        if (a == b) return 0;
+        return 1;
+    }
 };
 
-typedef void (*DynArrayErrorCallback)(DynArrayError error, void *context);
 
-/**
- * Dynamic array structure.
- *
- * Random access variable sized list data structure.
- *
- * @tparam T The type of elements
- * @tparam Alloc The allocator to be used to allocate the elements.
- * @tparam ErrorCb The callback that's called when an error happens.
- */
-template <class T, class Alloc>
-class DynArray
-{
-    template <class X, class Y> friend class DynArray; // To make different instantiations access each other.
+/**
+ * Dynamic array structure.
+ *
+ * Random access variable sized list data structure.
+ *
+ * @tparam T The type of elements
+ * @tparam Alloc The allocator to be used to allocate the elements.
+ * @tparam GrowthPolicy Decides the new capacity when the array needs to grow. See DynArrayDoublingGrowth.
+ * @tparam ErrorPolicy Decides how errors are handled and whether bounds are checked. See DynArrayRuntimeErrors.
+ */
+template <class T, class Alloc, class GrowthPolicy = DynArrayDoublingGrowth, class ErrorPolicy = DynArrayRuntimeErrors>
+class DynArray : public ErrorPolicy
+{
+    template <class X, class Y, class Z, class W> friend class DynArray; // To make different instantiations access each other.
+
+private:
+    T* buf = nullptr; ///< The buffer that holds the data.
+    size_t n = 0; ///< The number of elements in the array.
+    size_t nAllocd = 0; ///< The number of elements allocated in the array.
+    Alloc ator; ///< An instance of the allocator.
+    bool alive = true; ///< True if the object is alive and usable;
+
+    typedef DynArrayRelocator<T> Relocator;
+    typedef DynArrayAllocTraits<T, Alloc> AllocTraits;
+
+    /**
+     * True if Iterator is a pointer to T itself. Only such ranges are block copied: a pointer to a type derived from
+     * T also converts to const T*, but it steps over the derived elements.
+     */
+    template <class Iterator> using IsElementPointer = std::integral_constant<bool, std::is_pointer<Iterator>::value &&
+        std::is_same<typename std::remove_cv<typename std::remove_pointer<Iterator>::type>::type, T>::value>;
+
+    /**
+     * Constructs object from another object.
+     *
+     * @param[in] arr Array to construct from.
+     * @returns Zero on success, non-zero on failure.
+     *
+     * @remarks
+     *  The new buffer is sized to hold exactly the elements of arr.
+     */
+    int constructFrom(const DynArray<T, Alloc, GrowthPolicy, ErrorPolicy> &arr)
+    {
+        buf = nullptr;
+        nAllocd = 0;
+        n = 0;
+        ator = arr.ator;
+        static_cast<ErrorPolicy&>(*this) = arr;
+        alive = true;
+
+        if (arr.n == 0) return 0;
+
+        buf = ator.allocate(arr.n);
+        if (buf == nullptr)
+        {
+            this->reportError(DynArrayError::ALLOCATION_FAILURE);
+            alive = false;
+            return -1;
+        }
+
+        Relocator::copy(buf, arr.buf, arr.n);
+        n = arr.n;
+        nAllocd = arr.n;
+
+        return 0;
+    }
+
+
+    /**
+     * Constructs the object by moving another object.
+     *
+     * @param[in] arr Array to move from.
+     *
+     * @remarks
+     *  The source array will be cleared.
+     */
+    void moveFrom(DynArray<T, Alloc, GrowthPolicy, ErrorPolicy> &&arr)
+    {
+        n = arr.n;
+        nAllocd = arr.nAllocd;
+        buf = arr.buf;
+        ator = arr.ator;
+        alive = arr.alive;
+        static_cast<ErrorPolicy&>(*this) = arr;
+
+        if (arr.buf && AllocTraits::isInline(arr.ator, arr.buf))
+        {
+            // The buffer lives inside the source's allocator, so the elements have to move instead.
+            buf = nullptr;
+            nAllocd = 0;
+
+            if (arr.n)
+            {
+                buf = ator.allocate(arr.n);
+                if (!buf)
+                {
+                    this->reportError(DynArrayError::ALLOCATION_FAILURE);
+                    alive = false;
+                    n = 0;
+                    return;
+                }
+
+                Relocator::relocate(buf, arr.buf, arr.n);
+                nAllocd = AllocTraits::usableSize(ator, buf, arr.n);
+            }
+
+            arr.ator.deallocate(arr.buf);
+        }
+
+        arr.n = 0;
+        arr.nAllocd = 0;
+        arr.buf = nullptr;
+    }
+
+
+    /**
+     * The destructor function.
+     */
+    void destruct()
+    {
+        Relocator::destroy(buf, n);
+        if (buf) ator.deallocate(buf);
+        buf = nullptr;
+        n = 0;
+        nAllocd = 0;
+    }
+
+
+    /**
+     * Moves the elements into a buffer that can hold newAllocd elements.
+     *
+     * When growing, in place expansion is attempted first if the allocator supports it. Otherwise trivially
+     * relocatable types go through the allocator's reallocate, other types are move constructed into a new buffer.
+     *
+     * @param[in] newAllocd The new capacity. Must not be less than n.
+     * @returns Zero on success, non-zero on failure. On failure the buffer is left untouched.
+     */
+    int reallocateBuffer(size_t newAllocd)
+    {
+        if (newAllocd == 0)
+        {
+            // Reallocating to zero is allowed to free the buffer and return nullptr, so release it explicitly.
+            if (buf) ator.deallocate(buf);
+            buf = nullptr;
+            nAllocd = 0;
+            return 0;
+        }
+
+        if (buf && (newAllocd > nAllocd) && AllocTraits::tryExpand(ator, buf, nAllocd, newAllocd))
+        {
+            nAllocd = newAllocd;
+            return 0;
+        }
+
+        T *newBuf = reallocateBuffer(newAllocd, typename Relocator::TriviallyRelocatable());
+
+        if (!newBuf)
+        {
+            this->reportError(DynArrayError::ALLOCATION_FAILURE);
+            return -1;
+        }
+
+        buf = newBuf;
+        nAllocd = newAllocd;
+
+        return 0;
+    }
+
+    T *reallocateBuffer(size_t newAllocd, std::true_type)
+    {
+        return ator.reallocate(buf, newAllocd);
+    }
+
+    T *reallocateBuffer(size_t newAllocd, std::false_type)
+    {
+        T *newBuf = ator.allocate(newAllocd);
+        if (!newBuf) return nullptr;
+
+        Relocator::relocate(newBuf, buf, n);
+        if (buf) ator.deallocate(buf);
+
+        return newBuf;
+    }
+
+
+    int ensureSize(size_t newN)
+    {
+        if (nAllocd >= newN) return 0;
+
+        if (reallocateBuffer(GrowthPolicy::grow(nAllocd, newN, sizeof(T)))) return -1;
+
+        // Use the slack the allocator gave us, so the next growth happens later.
+        nAllocd = AllocTraits::usableSize(ator, buf, nAllocd);
+
+        return 0;
+    }
+
+    /**
+     * Makes room for count more elements.
+     *
+     * @returns Zero on success, non-zero on failure. Sets ALLOCATION_FAILURE if the new size would overflow.
+     */
+    int ensureExtra(size_t count)
+    {
+        if (count <= nAllocd - n) return 0;
+
+        if (count > SIZE_MAX / sizeof(T) - n)
+        {
+            this->reportError(DynArrayError::ALLOCATION_FAILURE);
+            return -1;
+        }
+
+        return ensureSize(n + count);
+    }
+
+    /**
+     * The addRange implementations, selected by the iterator category and whether the iterator is a pointer to T.
+     */
+    // @{
+    template <class Iterator, class IsPointer>
+    int appendRange(Iterator start, Iterator end, std::input_iterator_tag, IsPointer)
+    {
+        for (Iterator current = start; current != end; ++current)
+        {
+            if (add(*current)) return -1;
+        }
+
+        return 0;
+    }
+
+    template <class Iterator>
+    int appendRange(Iterator start, Iterator end, std::random_access_iterator_tag, std::false_type)
+    {
+        size_t count = end - start;
+
+        if (ensureExtra(count)) return -1;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            new (buf + n + i) T(start[i]);
+        }
+        n += count;
+
+        return 0;
+    }
+
+    template <class Iterator>
+    int appendRange(Iterator startIt, Iterator endIt, std::random_access_iterator_tag, std::true_type)
+    {
+        const T *start = startIt;
+        size_t count = endIt - startIt;
+
+        if (count > nAllocd - n)
+        {
+            // The range may be part of this array, growing would move it.
+            bool inside = buf && (start >= buf) && (start < buf + n);
+            size_t offset = inside ? start - buf : 0;
+
+            if (ensureExtra(count)) return -1;
+            if (inside) start = buf + offset;
+        }
+
+        Relocator::copy(buf + n, start, count);
+        n += count;
+
+        return 0;
+    }
+    // @}
+
+    /**
+     * The insertRange implementations, selected the same way as the addRange ones.
+     */
+    // @{
+    template <class Iterator, class IsPointer>
+    int insertElements(size_t index, Iterator start, Iterator end, std::input_iterator_tag, IsPointer)
+    {
+        // The count isn't known up front, so append and rotate the new elements into place.
+        size_t oldN = n;
+
+        if (appendRange(start, end, std::input_iterator_tag(), std::false_type()))
+        {
+            truncate(oldN);
+            return -1;
+        }
+
+        std::rotate(buf + index, buf + oldN, buf + n);
+
+        return 0;
+    }
+
+    template <class Iterator>
+    int insertElements(size_t index, Iterator start, Iterator end, std::forward_iterator_tag, std::false_type)
+    {
+        size_t count = std::distance(start, end);
+
+        if (ensureExtra(count)) return -1;
+
+        Relocator::relocateOverlapping(buf + index + count, buf + index, n - index);
+        for (size_t i = 0; i < count; i++, ++start)
+        {
+            new (buf + index + i) T(*start);
+        }
+        n += count;
+
+        return 0;
+    }
+
+    template <class Iterator>
+    int insertElements(size_t index, Iterator startIt, Iterator endIt, std::forward_iterator_tag, std::true_type)
+    {
+        const T *start = startIt;
+        size_t count = endIt - startIt;
+
+        // The range may be part of this array, both growing and opening the gap would move it.
+        bool inside = buf && (start >= buf) && (start < buf + n);
+        size_t offset = inside ? start - buf : 0;
+
+        if (ensureExtra(count)) return -1;
+
+        Relocator::relocateOverlapping(buf + index + count, buf + index, n - index);
+
+        if (inside)
+        {
+            // The part of the range before the gap stayed, the rest moved behind it.
+            size_t before = offset < index ? index - offset : 0;
+            if (before > count) before = count;
+
+            Relocator::copy(buf + index, buf + offset, before);
+            Relocator::copy(buf + index + before, buf + (offset + before) + count, count - before);
+        }
+        else
+        {
+            Relocator::copy(buf + index, start, count);
+        }
+        n += count;
+
+        return 0;
+    }
+    // @}
+
+    /**
+     * The removeIf implementations. Trivially copyable elements are compacted without branching on the predicate:
+     * every element is written to the output position, which only advances past the kept ones. Predicates from
+     * simd_predicates.h compact a vector at a time.
+     */
+    // @{
+    template <class Predicate> size_t compact(const Predicate &p, std::true_type)
+    {
+        return simdCompress(buf, n, p, false, buf);
+    }
+
+    template <class Predicate> size_t compact(const Predicate &p, std::false_type)
+    {
+        size_t kept = 0;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            if (p(buf[i]))
+            {
+                Relocator::destroy(buf + i, 1);
+            }
+            else
+            {
+                if (kept != i) Relocator::relocate(buf + kept, buf + i, 1);
+                kept++;
+            }
+        }
+
+        return kept;
+    }
+
+    template <class Predicate> size_t retainIf(const Predicate &p, std::true_type)
+    {
+        return removeIf(SimdNot<Predicate>(p));
+    }
+
+    template <class Predicate> size_t retainIf(const Predicate &p, std::false_type)
+    {
+        return removeIf([&p](const T &elem) {return !p(elem);});
+    }
+    // @}
+
+    /**
+     * Finds the first or last element matching the predicate in [start, end). Predicates from simd_predicates.h
+     * are evaluated with the vector kernels.
+     */
+    // @{
+    template <class Predicate> ssize_t scanFirst(size_t start, size_t end, const Predicate &p)
+    {
+        ssize_t found = simdFindFirst(buf + start, end - start, p);
+
+        return found < 0 ? -1 : start + found;
+    }
+
+    template <class Predicate> ssize_t scanLast(size_t start, size_t end, const Predicate &p)
+    {
+        ssize_t found = simdFindLast(buf + start, end - start, p);
+
+        return found < 0 ? -1 : start + found;
+    }
+    // @}
+
+    /**
+     * Returns the index of the first element in [start, start + length) that is not less than elem (Upper = false)
+     * or greater than elem (Upper = true), or start + length if there is none. The range is not checked.
+     *
+     * Each step narrows the range with a conditional move and prefetches both possible midpoints of the next step.
+     */
+    template <typename Compare, bool Upper> size_t boundOf(size_t start, size_t length, const T &elem) const
+    {
+        if (length == 0) return start;
+
+        const T *base = buf + start;
+        Compare c;
+
+        while (length > 1)
+        {
+            size_t half = length / 2;
+            size_t next = (length - half) / 2;
+
+            __builtin_prefetch(base + next);
+            __builtin_prefetch(base + half + next);
+            base = (Upper ? c(base[half], elem) <= 0 : c(base[half], elem) < 0) ? base + half : base;
+            length -= half;
+        }
+
+        return (base - buf) + (Upper ? c(*base, elem) <= 0 : c(*base, elem) < 0);
+    }
+
+    static const size_t searchGroupSize = 16; ///< The number of keys the batch searches run in lockstep.
+
+    /**
+     * Finds the lower bounds of up to searchGroupSize keys in the whole array, interleaving the searches.
+     *
+     * Every search takes the same number of steps over the same lengths, so they advance together and one step of
+     * each is issued before the next step of any. The loads of the group overlap instead of waiting on each other's
+     * cache misses, and the next midpoint of each search is prefetched as soon as it's known.
+     */
+    template <typename Compare> void lowerBoundGroup(const T *keys, size_t count, ssize_t *indices) const
+    {
+        const T *base[searchGroupSize];
+        size_t length = n;
+        Compare c;
+
+        for (size_t j = 0; j < count; j++) base[j] = buf;
+
+        if (length == 0)
+        {
+            for (size_t j = 0; j < count; j++) indices[j] = 0;
+            return;
+        }
+
+        while (length > 1)
+        {
+            size_t half = length / 2;
+            size_t next = (length - half) / 2;
+
+            for (size_t j = 0; j < count; j++)
+            {
+                base[j] = (c(base[j][half], keys[j]) < 0) ? base[j] + half : base[j];
+                __builtin_prefetch(base[j] + next);
+            }
+
+            length -= half;
+        }
+
+        for (size_t j = 0; j < count; j++) indices[j] = (base[j] - buf) + (c(*base[j], keys[j]) < 0);
+    }
+
+    /**
+     * Appends the elements matching the predicate to the given array, the findAll implementations. Predicates from
+     * simd_predicates.h are compressed a block at a time straight into the result.
+     */
+    // @{
+    template <class Predicate, class Result> int collect(Result &array, const Predicate &p, std::true_type) const
+    {
+        const size_t blockSize = 4096;
+
+        for (size_t i = 0; i < n; i += blockSize)
+        {
+            size_t count = n - i < blockSize ? n - i : blockSize;
+
+            if (array.ensureExtra(count)) return -1;
+            array.n += simdCompress(buf + i, count, p, true, array.buf + array.n);
+        }
+
+        return 0;
+    }
+
+    template <class Predicate, class Result> int collect(Result &array, const Predicate &p, std::false_type) const
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            if (p(buf[i]) && array.add(buf[i])) return -1;
+        }
+
+        return 0;
+    }
+    // @}
+public:
+
+    /**
+     * Default constructor. Initializes and empty array.
+     *
+     * @param[in] alloc An instance of the allocator used to allocate the elements for this structure.
+     */
+    DynArray(const Alloc &alloc = Alloc()) : ator(alloc) {}
+
+    // Standard stuff
+
+    /**
+     * Destructor. Releases the memory.
+     */
+    ~DynArray() {destruct();}
+
+    /**
+     * Copy constructor.
+     *
+     * @param[in] arr: object to contruct from.
+     *
+     * @remarks
+     * Upon allocation failure the object may remain in a zombie state, so use isAlive() function
+     * to determine the object is usable.
+     */
+    DynArray(const DynArray<T, Alloc, GrowthPolicy, ErrorPolicy> &arr)
+    {
+        constructFrom(arr);
+    }
+
+    /**
+     * Assignment operator.
+     *
+     * @param[in] arr object to deep copy from.
+     * @returns Reference to self.
+     *
+     * @remarks
+     * Upon allocation failure the object may remain in a zombie state, so use isAlive() function
+     * to determine the object is usable.
+     */
+    DynArray<T, Alloc, GrowthPolicy, ErrorPolicy>& operator=(const DynArray<T, Alloc, GrowthPolicy, ErrorPolicy> &arr)
+    {
+        if (this == &arr) return *this;
+
+        destruct();
+        constructFrom(arr);
+
+        return *this;
+    }
+
+    /**
+     * Move constructor.
+     *
+     * @param[in,out] arr array to move from.
+     *
+     * @remarks
+     * No deep copy is performed, so the object will be alive.
+     * The source object will be cleared to empty.
+     */
+    DynArray(DynArray<T, Alloc, GrowthPolicy, ErrorPolicy> &&arr)
+    {
+        moveFrom(static_cast<DynArray<T, Alloc, GrowthPolicy, ErrorPolicy>&&>(arr));
+    }
+
+    /**
+     * Move assignment operator.
+     *
+     * @param[in,out] arr array to move from.
+     *
+     * @returns reference to the left side of the assignment.
+     */
+    DynArray<T, Alloc, GrowthPolicy, ErrorPolicy>& operator=(DynArray<T, Alloc, GrowthPolicy, ErrorPolicy> &&arr)
+    {
+        if (this == &arr) return *this;
+
+        destruct();
+        moveFrom(static_cast<DynArray<T, Alloc, GrowthPolicy, ErrorPolicy>&&>(arr));
+
+        return *this;
+    }
+
+    // Iterators (for range based for loop)
+
+    /**
+     * @returns an iterator to the beginning of the array.
+     *
+     * @warning
+     *  Operations on this iterator is unchecked, be careful when using it.
+     *
+     * @remarks
+     *  It's highly recommended to use range based for loops when using these iterators as it's less error prone.
+     */
+    // @{
+    const T *begin() const {return buf;}
+    T *begin() {return buf;}
+    // @}
+
+    /**
+     * @returns and iterator to the end (one element beyond the end).
+     *
+     * @warning
+     *  Dereferencing this iterator is undefined behavior.
+     *
+     * @remarks
+     *  It's highly recommended to use range based for loops when using these iterators as it's less error prone.
+     */
+    // @{
+    T *end() {return buf + n;}
+    const T *end() const {return buf + n;}
+    // @}
+
+    // Operations
+
+    /**
+     * Queries the element at the given index.
+     *
+     * @param index The index to query.
+     * @returns A reference to an element there.
+     *
+     * @remarks
+     *  On out of bounds access the INDEX_OUT_OF_RANGE error will be set and the operator returns
+     *  a nullptr reference. Which crashes the program immediately if used.
+     *
+     *  For bulk operations prefer using iterators and range based for loops.
+     */
+    T& operator[](size_t index)
+    {
+        if (ErrorPolicy::checkBounds && (index >= n))
+        {
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
+            return *static_cast<T*>(nullptr);
+        }
+
+        return buf[index];
+    }
+
+    /**
+     * Checks if the object is alive.
+     *
+     * When memory allocation fails during construction, it leaves the object in a "zombie" state.
+     * The user must check if the object is alive after copy or move construction or assignment.
+     *
+     * @returns True if the object is alive.
+     */
+    bool isAlive() {return alive;}
+
+    /**
+     * Adds element to the dynamic array.
+     *
+     * @param[in] elem Element to add. It's copied, or moved if it's an rvalue. May be an element of this array.
+     * @returns On success the return value is 0. On failure the return value is -1.
+     *
+     * @remarks
+     * The only possible error is ALLOCATION_FAILURE.
+     */
+    // @{
+    int add(const T &elem) {return emplace(elem);}
+    int add(T &&elem) {return emplace(static_cast<T&&>(elem));}
+    // @}
+
+
+    /**
+     * Constructs an element at the end of the array in place.
+     *
+     * @param[in] args The arguments passed to the constructor of T. They may refer to elements of this array.
+     * @returns On success the return value is 0. On failure the return value is -1.
+     *
+     * @remarks
+     * The only possible error is ALLOCATION_FAILURE. When the array has to grow, the element is constructed before
+     * the growth and moved in after it, so on failure rvalue arguments may have been moved from.
+     */
+    template <class... Args> int emplace(Args&&... args)
+    {
+        if (n < nAllocd)
+        {
+            new (buf + n) T(std::forward<Args>(args)...);
+        }
+        else
+        {
+            // Growing moves the elements, the arguments could refer to them.
+            T elem(std::forward<Args>(args)...);
+
+            if (ensureSize(n + 1)) return -1;
+            new (buf + n) T(static_cast<T&&>(elem));
+        }
+        n++;
+
+        return 0;
+    }
 
-private:
-    T* buf = nullptr; ///< The buffer that holds the data.
-    size_t n = 0; ///< The number of elements in the array.
-    size_t nAllocd = 0; ///< The number of elements allocated in the array.
-    Alloc ator; ///< An instance of the allocator.
-    bool alive = true; ///< True if the object is alive and usable;
-    DynArrayErrorCallback errorCb = [](DynArrayError, void*){};
-    void *errorCbCtx = nullptr;
 
     /**
-     * Constructs object from another object.
+     * Adds multiple elements to the dynamic array.
      *
-     * @param[in] arr Array to construct from.
+     * @param[in] start Iterator to the start of the range.
+     * @param[in] end Iterator to the end of the range (on element beyond the last).
      * @returns Zero on success, non-zero on failure.
+     *
+     * @remarks
+     *    If we run out of memory the ALLOCATION_FAILURE error is set.
+     *    For random access iterators the array grows once and on failure no elements are added. Pointers to
+     *    trivially copyable elements are block copied and may point into this array. Other iterators add the
+     *    elements one by one, so on failure the elements before the failing one stay added.
      */
-    int constructFrom(const DynArray<T, Alloc> &arr)
+    template <typename InputIterator> int addRange(InputIterator start, InputIterator end)
     {
-        nAllocd = arr.nAllocd;
-        n = arr.n;
-        ator = arr.ator;
-        buf = ator.allocate(n);
-        if (buf == nullptr)
+        return appendRange(start, end, typename std::iterator_traits<InputIterator>::iterator_category(),
+            IsElementPointer<InputIterator>());
+    }
+
+
+    /**
+     * Adds count copies of the value to the end of the array.
+     *
+     * @param[in] count The number of elements to add.
+     * @param[in] value The value to copy. May be an element of this array.
+     * @returns Zero on success, non-zero on failure.
+     *
+     * @remarks
+     *    If we run out of memory the ALLOCATION_FAILURE error is set and no elements are added.
+     */
+    int addN(size_t count, const T &value)
+    {
+        if (count > nAllocd - n)
         {
-            errorCb(DynArrayError::ALLOCATION_FAILURE, errorCbCtx);
-            alive = false;
-            nAllocd = 0;
-            n = 0;
-            return -1;
+            if (buf && (&value >= buf) && (&value < buf + n))
+            {
+                // Growing would move the value, so work from a copy.
+                T copy(value);
+                return addN(count, copy);
+            }
+
+            if (ensureExtra(count)) return -1;
         }
-        errorCb = arr.errorCb;
-        errorCbCtx = arr.errorCbCtx;
 
-        for (size_t i = 0; i < n; i++)
+        for (size_t i = 0; i < count; i++)
         {
-            buf[i] = arr.buf[i];
+            new (buf + n + i) T(value);
         }
+        n += count;
 
         return 0;
     }
 
 
     /**
-     * Constructs the object by moving another object.
+     * Adds count elements to the end of the array without initializing them.
      *
-     * @param[in] arr Array to move from.
+     * The caller writes the elements through the returned pointer, for example with read(2) or a decoder, without
+     * an intermediate buffer. Use truncate to drop the elements that weren't filled.
+     *
+     * @param[in] count The number of elements to add.
+     * @returns Pointer to the first added element, nullptr on failure.
      *
      * @remarks
-     *  The source array will be cleared.
+     *    Only for trivially copyable types. The returned pointer is valid until the array next grows.
+     *    Adding zero elements to an array without a buffer returns nullptr too.
+     *    If we run out of memory the ALLOCATION_FAILURE error is set and no elements are added.
      */
-    void moveFrom(DynArray<T, Alloc> &&arr)
+    T *appendUninitialized(size_t count)
     {
-        n = arr.n;
-        nAllocd = arr.nAllocd;
-        buf = arr.buf;
-        ator = arr.ator;
-        alive = arr.alive;
-        errorCb = arr.errorCb;
-        errorCbCtx = arr.errorCbCtx;
+        static_assert(std::is_trivially_copyable<T>::value, "The elements must be trivially copyable.");
 
-        arr.n = 0;
-        arr.nAllocd = 0;
-        arr.buf = nullptr;
+        if (ensureExtra(count)) return nullptr;
+
+        T *added = buf + n;
+        n += count;
+
+        return added;
     }
 
 
     /**
-     * The destructor function.
+     * Inserts an element at the given index, shifting the elements from there one place up.
+     *
+     * @param[in] index The index of the new element. If it equals the number of elements, the element is appended.
+     * @param[in] elem Element to insert. It's copied, or moved if it's an rvalue. May be an element of this array.
+     * @returns Zero on success, non-zero on failure.
+     *
+     * @remarks
+     *    If the index is out of range the INDEX_OUT_OF_RANGE error is set.
+     *    If we run out of memory the ALLOCATION_FAILURE error is set.
+     *    Trivially relocatable elements are shifted with a single memmove.
      */
-    void destruct()
+    // @{
+    int insertAt(size_t index, const T &elem) {return emplaceAt(index, elem);}
+    int insertAt(size_t index, T &&elem) {return emplaceAt(index, static_cast<T&&>(elem));}
+    // @}
+
+
+    /**
+     * Constructs an element at the given index in place, shifting the elements from there one place up.
+     *
+     * @param[in] index The index of the new element. If it equals the number of elements, the element is appended.
+     * @param[in] args The arguments passed to the constructor of T. They may refer to elements of this array.
+     * @returns Zero on success, non-zero on failure.
+     *
+     * @remarks
+     *    The element is constructed before the shift and moved into its place after.
+     *    Errors are the same as of insertAt.
+     */
+    template <class... Args> int emplaceAt(size_t index, Args&&... args)
     {
-        if (buf) ator.deallocate(buf);
+        if (ErrorPolicy::checkBounds && (index > n))
+        {
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
+            return -1;
+        }
+
+        T elem(std::forward<Args>(args)...);
+
+        if (ensureSize(n + 1)) return -1;
+
+        Relocator::relocateOverlapping(buf + index + 1, buf + index, n - index);
+        new (buf + index) T(static_cast<T&&>(elem));
+        n++;
+
+        return 0;
     }
 
 
-    int ensureSize(size_t newN)
+    /**
+     * Inserts multiple elements at the given index, shifting the elements from there up once.
+     *
+     * @param[in] index The index of the first new element. If it equals the number of elements, the elements are
+     *      appended.
+     * @param[in] start Iterator to the start of the range.
+     * @param[in] end Iterator to the end of the range (on element beyond the last).
+     * @returns Zero on success, non-zero on failure. On failure the array is not changed.
+     *
+     * @remarks
+     *    If the index is out of range the INDEX_OUT_OF_RANGE error is set.
+     *    If we run out of memory the ALLOCATION_FAILURE error is set.
+     *    Pointers to elements may point into this array. Input iterators that can be traversed only once are
+     *    appended first and rotated into place.
+     */
+    template <typename InputIterator> int insertRange(size_t index, InputIterator start, InputIterator end)
     {
-        if (nAllocd > newN) return 0;
+        if (ErrorPolicy::checkBounds && (index > n))
+        {
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
+            return -1;
+        }
 
-        size_t newAllocd = nAllocd;
+        return insertElements(index, start, end, typename std::iterator_traits<InputIterator>::iterator_category(),
+            IsElementPointer<InputIterator>());
+    }
 
-        if (newAllocd == 0) newAllocd = 8;
 
-        while (newAllocd < newN) newAllocd *= 2;
+    /**
+     * Removes the element at the given index, shifting the elements after it one place down.
+     *
+     * @param[in] index The index of the element to remove.
+     * @returns Zero on success, non-zero on failure.
+     *
+     * @remarks
+     *    If the index is out of range the INDEX_OUT_OF_RANGE error is set.
+     *    The capacity is not changed.
+     */
+    int removeAt(size_t index)
+    {
+        return removeRange(index, 1);
+    }
 
-        T *newBuf = ator.reallocate(buf, newAllocd);
 
-        if (!newBuf)
+    /**
+     * Removes count elements starting at the given index, shifting the elements after them down once.
+     *
+     * @param[in] index The index of the first element to remove.
+     * @param[in] count The number of elements to remove.
+     * @returns Zero on success, non-zero on failure.
+     *
+     * @remarks
+     *    If the range is out of range the INDEX_OUT_OF_RANGE error is set.
+     *    The capacity is not changed.
+     */
+    int removeRange(size_t index, size_t count)
+    {
+        if (ErrorPolicy::checkBounds && ((index > n) || (count > n - index)))
         {
-            errorCb(DynArrayError::ALLOCATION_FAILURE, errorCbCtx);
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
             return -1;
         }
 
-        buf = newBuf;
-        nAllocd = newAllocd;
+        Relocator::destroy(buf + index, count);
+        Relocator::relocateOverlapping(buf + index, buf + index + count, n - index - count);
+        n -= count;
 
         return 0;
     }
-public:
+
 
     /**
-     * Default constructor. Initializes and empty array.
+     * Removes the element at the given index by moving the last element into its place.
      *
-     * @param[in] alloc An instance of the allocator used to allocate the elements for this structure.
+     * O(1), but doesn't keep the order of the elements.
+     *
+     * @param[in] index The index of the element to remove.
+     * @returns Zero on success, non-zero on failure.
+     *
+     * @remarks
+     *    If the index is out of range the INDEX_OUT_OF_RANGE error is set.
      */
-    DynArray(const Alloc &alloc = Alloc()) : ator(alloc) {}
+    int swapRemove(size_t index)
+    {
+        if (ErrorPolicy::checkBounds && (index >= n))
+        {
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
+            return -1;
+        }
+
+        Relocator::destroy(buf + index, 1);
+        n--;
+        if (index != n) Relocator::relocate(buf + index, buf + n, 1);
+
+        return 0;
+    }
 
-    // Standard stuff
 
     /**
-     * Destructor. Releases the memory.
+     * Removes the elements matching the predicate in place, keeping the order of the rest.
+     *
+     * The array is compacted in a single pass without allocating, unlike building a filtered copy with findAll.
+     *
+     * @tparam Predicate A functor with the following signature: bool predicate(const T &elem) which returns true if
+     *      the element should be removed.
+     * @param[in] p An instance of the predicate.
+     * @returns The number of elements removed.
+     *
+     * @remarks
+     *    The predicate is called exactly once for each element, in order. The capacity is not changed.
+     *    Predicates built with simd_predicates.h are evaluated a vector at a time instead of calling the functor.
      */
-    ~DynArray() {destruct();}
+    template <class Predicate> size_t removeIf(const Predicate &p)
+    {
+        size_t kept = compact(p, typename Relocator::TriviallyCopyable());
+        size_t removed = n - kept;
+
+        n = kept;
+
+        return removed;
+    }
+
 
     /**
-     * Copy constructor.
+     * Keeps only the elements matching the predicate, the opposite of removeIf.
      *
-     * @param[in] arr: object to contruct from.
+     * @tparam Predicate A functor with the following signature: bool predicate(const T &elem) which returns true if
+     *      the element should be kept.
+     * @param[in] p An instance of the predicate.
+     * @returns The number of elements removed.
+     */
+    template <class Predicate> size_t retainIf(const Predicate &p)
+    {
+        return retainIf(p, SimdPredicateFor<Predicate, T>());
+    }
+
+
+    /**
+     * Removes elements from the end of the array, so at most count elements remain.
+     *
+     * @param[in] count The number of elements to keep. If not less than the number of elements nothing happens.
      *
      * @remarks
-     * Upon allocation failure the object may remain in a zombie state, so use isAlive() function
-     * to determine the object is usable.
+     *    The capacity is not changed.
      */
-    DynArray(const DynArray<T, Alloc> &arr)
+    void truncate(size_t count)
     {
-        constructFrom(arr);
+        if (count >= n) return;
+
+        Relocator::destroy(buf + count, n - count);
+        n = count;
     }
 
+
     /**
-     * Assignment operator.
+     * Performs binary search.
      *
-     * @param[in] arr object to deep copy from.
-     * @returns Reference to self.
+     * The search is branchless: each step halves the range with a conditional move instead of a jump, so it doesn't
+     * mispredict, and both possible midpoints of the next step are prefetched while the current one is compared.
+     *
+     * @tparam Compare A comparator type. It must be a functor with the signature:
+     *      int compare(const T &a, const T &b); Which returns negative if a < b, positive if a > b,
+     *      zero if a == b.
+     *
+     * @param[in] start The start index of the range.
+     * @param[in] length The number of elements in the range.
+     * @param[in] elem The element to search for.
+     * @returns true if the elements is found, false if not.
+     *
+     * @remarks
+     * The array must be sorted in order to work.
+     * If the indexes are out of range the function returns false and the INDEX_OUT_OF_RANGE error is set.
+     */
+    template <typename Compare> bool binarySearch(size_t start, size_t length, const T &elem)
+    {
+        if (ErrorPolicy::checkBounds && ((start > n) || (length > n - start)))
+        {
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
+            return false;
+        }
+
+        size_t index = boundOf<Compare, false>(start, length, elem);
+
+        return (index < start + length) && (Compare()(elem, buf[index]) == 0);
+    }
+
+
+    /**
+     * Performs binary search.
+     *
+     * @tparam Compare Comparator.
+     *
+     * @param[in] elem The element to search form.
+     * @returns True if the elements is found, false otherwise.
+     *
+     * @remarks
+     * See the other overloads for more details.
+     */
+    template <typename Compare> bool binarySearch(const T &elem)
+    {
+        return binarySearch<Compare>(0, n, elem);
+    }
+
+    /**
+     * Performs binary search.
+     *
+     * @param elem The element to search for.
+     * @returns true if the elements is found, false otherwise.
+     *
+     * @remarks
+     *      Use this function only if T supports the == and < operators.
+     */
+    bool binarySearch(const T &elem)
+    {
+        return binarySearch<DynArrayCompare<T>>(elem);
+    }
+
+
+    /**
+     * Finds the first element that is not less than the given one in a sorted range.
+     *
+     * Together with upperBound this gives the position of an element, the place to insert it to keep the array
+     * sorted, or the elements in a key range, in O(log n).
+     *
+     * @tparam Compare Three way comparator, see binarySearch.
+     *
+     * @param[in] start The start index of the range.
+     * @param[in] length The number of elements in the range.
+     * @param[in] elem The element to search for.
+     * @returns The index of the first element in the range for which compare(element, elem) >= 0, start + length if
+     *      there is none. -1 on error.
+     *
+     * @remarks
+     * The range must be sorted in order to work.
+     * If the indexes are out of range the function returns -1 and the INDEX_OUT_OF_RANGE error is set.
+     */
+    template <typename Compare> ssize_t lowerBound(size_t start, size_t length, const T &elem)
+    {
+        if (ErrorPolicy::checkBounds && ((start > n) || (length > n - start)))
+        {
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
+            return -1;
+        }
+
+        return boundOf<Compare, false>(start, length, elem);
+    }
+
+    /**
+     * Finds the first element that is not less than the given one in the sorted array.
+     *
+     * @returns The index of the element, getCount() if there is none.
+     *
+     * @remarks
+     * See the other overloads for more details. The overload without Compare uses the == and < operators of T.
+     */
+    // @{
+    template <typename Compare> ssize_t lowerBound(const T &elem)
+    {
+        return lowerBound<Compare>(0, n, elem);
+    }
+
+    ssize_t lowerBound(const T &elem)
+    {
+        return lowerBound<DynArrayCompare<T>>(0, n, elem);
+    }
+    // @}
+
+
+    /**
+     * Finds the first element that is greater than the given one in a sorted range.
+     *
+     * @tparam Compare Three way comparator, see binarySearch.
+     *
+     * @param[in] start The start index of the range.
+     * @param[in] length The number of elements in the range.
+     * @param[in] elem The element to search for.
+     * @returns The index of the first element in the range for which compare(element, elem) > 0, start + length if
+     *      there is none. -1 on error.
      *
      * @remarks
-     * Upon allocation failure the object may remain in a zombie state, so use isAlive() function
-     * to determine the object is usable.
+     * The range must be sorted in order to work.
+     * If the indexes are out of range the function returns -1 and the INDEX_OUT_OF_RANGE error is set.
      */
-    DynArray<T, Alloc>& operator=(const DynArray<T, Alloc> &arr)
+    template <typename Compare> ssize_t upperBound(size_t start, size_t length, const T &elem)
     {
-        if (this == &arr) return *this;
+        if (ErrorPolicy::checkBounds && ((start > n) || (length > n - start)))
+        {
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
+            return -1;
+        }
 
-        destruct();
-        constructFrom(arr);
+        return boundOf<Compare, true>(start, length, elem);
     }
 
     /**
-     * Move constructor.
+     * Finds the first element that is greater than the given one in the sorted array.
      *
-     * @param[in,out] arr array to move from.
+     * @returns The index of the element, getCount() if there is none.
      *
      * @remarks
-     * No deep copy is performed, so the object will be alive.
-     * The source object will be cleared to empty.
+     * See the other overloads for more details. The overload without Compare uses the == and < operators of T.
      */
-    DynArray(DynArray<T, Alloc> &&arr)
+    // @{
+    template <typename Compare> ssize_t upperBound(const T &elem)
+    {
+        return upperBound<Compare>(0, n, elem);
+    }
+
+    ssize_t upperBound(const T &elem)
     {
-        moveFrom(static_cast<DynArray<T, Alloc>&&>(arr));
+        return upperBound<DynArrayCompare<T>>(0, n, elem);
     }
+    // @}
+
 
     /**
-     * Move assignment operator.
+     * Finds the elements equal to the given one in a sorted range.
      *
-     * @param[in,out] arr array to move from.
+     * @tparam Compare Three way comparator, see binarySearch.
      *
-     * @returns reference to the left side of the assignment.
+     * @param[in] start The start index of the range.
+     * @param[in] length The number of elements in the range.
+     * @param[in] elem The element to search for.
+     * @returns The pair of lowerBound and upperBound, the equal elements are at [first, second). If there is no
+     *      equal element both are the index where it would be inserted. {-1, -1} on error.
+     *
+     * @remarks
+     * The range must be sorted in order to work.
+     * If the indexes are out of range the function returns {-1, -1} and the INDEX_OUT_OF_RANGE error is set.
      */
-    DynArray<T, Alloc>& operator=(DynArray<T, Alloc> &&arr)
+    template <typename Compare> std::pair<ssize_t, ssize_t> equalRange(size_t start, size_t length, const T &elem)
     {
-        if (this == &arr) return *this;
+        if (ErrorPolicy::checkBounds && ((start > n) || (length > n - start)))
+        {
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
+            return std::pair<ssize_t, ssize_t>(-1, -1);
+        }
 
-        moveFrom(arr);
-    }
+        size_t first = boundOf<Compare, false>(start, length, elem);
+        size_t last = boundOf<Compare, true>(first, start + length - first, elem);
 
-    // Iterators (for range based for loop)
+        return std::pair<ssize_t, ssize_t>(first, last);
+    }
 
     /**
-     * @returns an iterator to the beginning of the array.
+     * Finds the elements equal to the given one in the sorted array.
      *
-     * @warning
-     *  Operations on this iterator is unchecked, be careful when using it.
+     * @returns The pair of lowerBound and upperBound, the equal elements are at [first, second).
      *
      * @remarks
-     *  It's highly recommended to use range based for loops when using these iterators as it's less error prone.
+     * See the other overloads for more details. The overload without Compare uses the == and < operators of T.
      */
     // @{
-    const T *begin() const {return buf;}
-    T *begin() {return buf;}
+    template <typename Compare> std::pair<ssize_t, ssize_t> equalRange(const T &elem)
+    {
+        return equalRange<Compare>(0, n, elem);
+    }
+
+    std::pair<ssize_t, ssize_t> equalRange(const T &elem)
+    {
+        return equalRange<DynArrayCompare<T>>(0, n, elem);
+    }
     // @}
 
+
     /**
-     * @returns and iterator to the end (one element beyond the end).
+     * Performs binary search for many keys at once.
      *
-     * @warning
-     *  Dereferencing this iterator is undefined behavior.
+     * The searches are interleaved in groups, so their cache misses overlap. Much faster than a loop of
+     * binarySearch calls when the array doesn't fit in the cache.
+     *
+     * @tparam Compare Three way comparator, see binarySearch.
+     *
+     * @param[in] keys The elements to search for.
+     * @param[in] count The number of keys.
+     * @param[out] found Receives true for each key that is found, false for the others. Room for count elements.
      *
      * @remarks
-     *  It's highly recommended to use range based for loops when using these iterators as it's less error prone.
+     * The array must be sorted in order to work. The overload without Compare uses the == and < operators of T.
      */
     // @{
-    T *end() {return buf + n;}
-    const T *end() const {return buf + n;}
+    template <typename Compare> void binarySearchBatch(const T *keys, size_t count, bool *found)
+    {
+        ssize_t indices[searchGroupSize];
+        Compare c;
+
+        for (size_t i = 0; i < count; i += searchGroupSize)
+        {
+            size_t group = count - i < searchGroupSize ? count - i : searchGroupSize;
+
+            lowerBoundGroup<Compare>(keys + i, group, indices);
+
+            for (size_t j = 0; j < group; j++)
+            {
+                found[i + j] = ((size_t)indices[j] < n) && (c(keys[i + j], buf[indices[j]]) == 0);
+            }
+        }
+    }
+
+    void binarySearchBatch(const T *keys, size_t count, bool *found)
+    {
+        binarySearchBatch<DynArrayCompare<T>>(keys, count, found);
+    }
     // @}
 
-    // Operations
 
     /**
-     * Queries the element at the given index.
+     * Finds the lower bounds of many keys at once, see lowerBound.
      *
-     * @param index The index to query.
-     * @returns A reference to an element there.
+     * The searches are interleaved in groups, so their cache misses overlap.
      *
-     * @remarks
-     *  On out of bounds access the INDEX_OUT_OF_RANGE error will be set and the operator returns
-     *  a nullptr reference. Which crashes the program immediately if used.
+     * @tparam Compare Three way comparator, see binarySearch.
      *
-     *  For bulk operations prefer using iterators and range based for loops.
+     * @param[in] keys The elements to search for.
+     * @param[in] count The number of keys.
+     * @param[out] indices Receives the index of the first element not less than each key, getCount() if there is
+     *      none. Room for count elements.
+     *
+     * @remarks
+     * The array must be sorted in order to work. The overload without Compare uses the == and < operators of T.
      */
-    T& operator[](size_t index)
+    // @{
+    template <typename Compare> void lowerBoundBatch(const T *keys, size_t count, ssize_t *indices)
     {
-        if (index >= n)
+        for (size_t i = 0; i < count; i += searchGroupSize)
         {
-            errorCb(DynArrayError::INDEX_OUT_OF_RANGE, errorCbCtx);
-            return *static_cast<T*>(nullptr);
+            size_t group = count - i < searchGroupSize ? count - i : searchGroupSize;
+
+            lowerBoundGroup<Compare>(keys + i, group, indices + i);
         }
+    }
 
-        return buf[index];
+    void lowerBoundBatch(const T *keys, size_t count, ssize_t *indices)
+    {
+        lowerBoundBatch<DynArrayCompare<T>>(keys, count, indices);
     }
+    // @}
+
 
     /**
-     * Checks if the object is alive.
+     * Sorts a range of the array in place.
      *
-     * When memory allocation fails during construction, it leaves the object in a "zombie" state.
-     * The user must check if the object is alive after copy or move construction or assignment.
+     * Uses pattern-defeating quicksort (see sort.h): O(n log n) in the worst case, close to linear on sorted, reversed
+     * and mostly equal ranges, and it never allocates. Equal elements may be reordered, use stableSort to keep them
+     * in order.
      *
-     * @returns True if the object is alive.
-     */
-    bool isAlive() {return alive;}
-
-    /**
-     * Adds element to the dynamic array.
+     * @tparam Compare Three way comparator, see binarySearch.
      *
-     * @param[in] elem Element to add.
-     * @returns On success the return value is 0. On failure the return value is -1.
+     * @param[in] start The start index of the range.
+     * @param[in] length The number of elements in the range.
+     * @returns Zero on success, non-zero on failure.
      *
      * @remarks
-     * The only possible error is ALLOCATION_FAILURE.
+     * If the indexes are out of range the function returns -1 and the INDEX_OUT_OF_RANGE error is set.
      */
-    int add(const T &elem)
+    template <typename Compare> int sort(size_t start, size_t length)
     {
-        if (ensureSize(n + 1)) return -1;
-        buf[n++] = elem;
+        if (ErrorPolicy::checkBounds && ((start > n) || (length > n - start)))
+        {
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
+            return -1;
+        }
+
+        sortUnstable(buf + start, length, Compare());
 
         return 0;
     }
 
-
     /**
-     * Adds multiple elements to the dynamic array.
-     *
-     * @param[in] start Iterator to the start of the range.
-     * @param[in] end Iterator to the end of the range (on element beyond the last).
-     * @returns Zero on success, non-zero on failure.
+     * Sorts the array in place, so it can be searched with binarySearch.
      *
      * @remarks
-     *    If we run out of memory the ALLOCATION_FAILURE error is set.
+     * See the other overloads for more details. The overload without Compare uses the == and < operators of T.
      */
-    template <typename ForwardIterator> int addRange(ForwardIterator start, ForwardIterator end)
+    // @{
+    template <typename Compare> void sort()
     {
-        for (ForwardIterator current = start; start != end; ++current)
-        {
-            if (add(*current)) return -1;
-        }
+        sortUnstable(buf, n, Compare());
+    }
 
-        return 0;
+    void sort()
+    {
+        sort<DynArrayCompare<T>>();
     }
+    // @}
 
 
     /**
-     * Performs binary search.
+     * Sorts a range of the array in place, keeping equal elements in their original order.
      *
-     * @tparam Compare A comparator type. It must be a functor with the signature:
-     *      int compare(const T &a, const T &b); Which returns negative if a < b, positive if a > b,
-     *      zero if a == b.
+     * Uses merge sort with a temporary buffer of length / 2 elements from the allocator. If that can't be allocated
+     * the halves are merged in place by rotations instead, which is O(n log^2 n), so the sort never fails for lack
+     * of memory.
+     *
+     * @tparam Compare Three way comparator, see binarySearch.
      *
      * @param[in] start The start index of the range.
      * @param[in] length The number of elements in the range.
-     * @param[in] elem The element to search for.
-     * @returns true if the elements is found, false if not.
+     * @returns Zero on success, non-zero on failure.
      *
      * @remarks
-     * The array must be sorted in order to work.
-     * If the indexes are out of range the function returns false and the INDEX_OUT_OF_RANGE error is set.
+     * If the indexes are out of range the function returns -1 and the INDEX_OUT_OF_RANGE error is set.
      */
-    template <typename Compare> bool binarySearch(size_t start, size_t length, const T &elem)
+    template <typename Compare> int stableSort(size_t start, size_t length)
     {
-        size_t left = start;
-        size_t right = start + length - 1;
-        Compare c;
-
-        if ((left >= n) || (right >= n))
+        if (ErrorPolicy::checkBounds && ((start > n) || (length > n - start)))
         {
-            errorCb(DynArrayError::INDEX_OUT_OF_RANGE, errorCbCtx);
-            return false;
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
+            return -1;
         }
 
-        while (left <= right)
-        {
-            size_t mid = (left + right) / 2;
-            int comparison = c(elem, buf[mid]);
-
-            if (comparison == 0) return true;
+        size_t scratchSize = sortStableScratchSize(length);
+        T *scratch = scratchSize ? ator.allocate(scratchSize) : nullptr;
 
-            if (comparison < 0)
-            {
-                right = mid - 1;
-            }
-            else if (comparison > 0)
-            {
-                left = mid + 1;
-            }
-        }
+        sortStable(buf + start, length, Compare(), scratch);
+        if (scratch) ator.deallocate(scratch);
 
-        return false;
+        return 0;
     }
 
-
     /**
-     * Performs binary search.
-     *
-     * @tparam Compare Comparator.
-     *
-     * @param[in] elem The element to search form.
-     * @returns True if the elements is found, false otherwise.
+     * Sorts the array in place, keeping equal elements in their original order.
      *
      * @remarks
-     * See the other overloads for more details.
+     * See the other overloads for more details. The overload without Compare uses the == and < operators of T.
      */
-    template <typename Compare> bool binarySearch(const T &elem)
+    // @{
+    template <typename Compare> void stableSort()
     {
-        return binarySearch<Compare>(0, n, elem);
+        stableSort<Compare>(0, n);
+    }
+
+    void stableSort()
+    {
+        stableSort<DynArrayCompare<T>>(0, n);
     }
+    // @}
+
 
     /**
-     * Performs binary search.
-     *
-     * @param elem The element to search for.
-     * @returns true if the elements is found, false otherwise.
+     * @returns The alignment of the underlying buffer in bytes as guaranteed by the allocator.
      *
      * @remarks
-     *      Use this function only if T supports the == and < operators.
+     *  The alignment holds for every buffer the array uses, including the ones after growth, setCapacity and copies.
      */
-    bool binarySearch(const T &elem)
-    {
-        struct Compare
-        {
-            int operator()(const T &a, const T &b)
-            {
-                if (a == b) return 0;
-                if (a < b) return -1;
-                return 1;
-            }
-        };
-
-        return binarySearch<Compare>(elem);
-    }
+    static constexpr size_t getAlignment() {return AllocTraits::alignment;}
 
 
     /**
@@ -416,20 +1857,11 @@ public:
     {
         if (newCapacity < n)
         {
-            errorCb(DynArrayError::INVALID_CAPACITY, errorCbCtx);
-            return -1;
-        }
-
-        T *newBuf = ator.reallocate(buf, newCapacity);
-        if (newBuf == nullptr)
-        {
-            errorCb(DynArrayError::ALLOCATION_FAILURE, errorCbCtx);
+            this->reportError(DynArrayError::INVALID_CAPACITY);
             return -1;
         }
-        buf = newBuf;
-        nAllocd = newCapacity;
 
-        return 0;
+        return reallocateBuffer(newCapacity);
     }
 
 
@@ -437,15 +1869,11 @@ public:
      * Removes all elements from the dynamic array.
      *
      * @remarks
-     * The elements will be destroyed.
+     * The elements will be destroyed. This is O(1) for trivially destructible types.
      */
     void clear()
     {
-        for (size_t i = 0; i < n; i++)
-        {
-            buf[i].~T();
-        }
-
+        Relocator::destroy(buf, n);
         n = 0;
     }
 
@@ -482,7 +1910,7 @@ public:
      */
     bool contains(const T &elem)
     {
-        return contains(elem, [](const T &x, const T &y){return x == y;} );
+        return simdIndexOf(buf, n, elem) >= 0;
     }
 
 
@@ -500,21 +1928,21 @@ public:
      * @remarks.
      *  On failure it returns an empty array. For the error reason call getLastError().
      */
-    template<class U, class UAlloc, class Converter> DynArray<U, UAlloc> convertAll(const Converter &c, const UAlloc &ualloc = UAlloc())
+    template<class U, class UAlloc, class Converter> DynArray<U, UAlloc, GrowthPolicy, ErrorPolicy> convertAll(const Converter &c, const UAlloc &ualloc = UAlloc())
     {
-        DynArray<U, UAlloc> newArray(ualloc);
+        DynArray<U, UAlloc, GrowthPolicy, ErrorPolicy> newArray(ualloc);
 
-        newArray.errorCb = errorCb;
+        static_cast<ErrorPolicy&>(newArray) = *this;
 
         if (newArray.setCapacity(nAllocd))
         {
-            errorCb(DynArrayError::ALLOCATION_FAILURE, errorCbCtx);
-            return DynArray<U, UAlloc>();
+            this->reportError(DynArrayError::ALLOCATION_FAILURE);
+            return DynArray<U, UAlloc, GrowthPolicy, ErrorPolicy>();
         }
 
         for (size_t i = 0; i < n; i++)
         {
-            newArray.buf[i] = c(buf[i]);
+            new (newArray.buf + i) U(c(buf[i]));
         }
         newArray.n = n;
 
@@ -547,12 +1975,6 @@ public:
     }
 
 
-    DynArrayErrorCallback getErrorCb() {return errorCb;}
-    void* getErrorCbCtx() {return errorCbCtx;}
-    void setErrorCb(DynArrayErrorCallback ecb, void *ctx) {errorCb = ecb; errorCbCtx = ctx;}
-
-
-
     /**
      * Check if an element with a given property exists in the collection.
      *
@@ -562,12 +1984,7 @@ public:
      */
     template <class Predicate> bool exists(const Predicate &p)
     {
-        for (size_t i = 0; i < n; i++)
-        {
-            if (p(buf[i])) return true;
-        }
-
-        return false;
+        return simdFindFirst(buf, n, p) >= 0;
     }
 
 
@@ -593,28 +2010,27 @@ public:
      * Finds all element with a given property.
      *
      * @tparam [in] Predicate A functor with the following signature: bool predicate(const T &elem) which returns true if the element matches the given condition.
+     * @tparam RAlloc The allocator type of the new array. Defaults to the allocator of this array.
      * @param [in] p An instance of the predicate.
      * @param [in] alloc An allocator to be used for the new array.
      *
      * @returns A new array of the matches. If no matches are found an empty array is returned.
      *      On error it returns an empty array to find out the reason call getLastError().
+     *
+     * @remarks
+     *    Predicates built with simd_predicates.h (simdLt, simdBetween...) are evaluated a vector at a time.
      */
-    template <class Predicate> DynArray<T, Alloc> findAll(const Predicate &p, Alloc alloc = Alloc())
+    template <class Predicate, class RAlloc = Alloc>
+    DynArray<T, RAlloc, GrowthPolicy, ErrorPolicy> findAll(const Predicate &p, const RAlloc &alloc = RAlloc())
     {
-        DynArray<T, Alloc> array(alloc);
+        DynArray<T, RAlloc, GrowthPolicy, ErrorPolicy> array(alloc);
 
-        array.errorCb = errorCb;
+        static_cast<ErrorPolicy&>(array) = *this;
 
-        for (size_t i = 0; i < n; i++)
+        if (collect(array, p, SimdPredicateFor<Predicate, T>()))
         {
-            if (p(buf[i]))
-            {
-                if (array.add(buf[i]))
-                {
-                    // Error adding.
-                    return DynArray<T, Alloc>();
-                }
-            }
+            // Error adding.
+            return DynArray<T, RAlloc, GrowthPolicy, ErrorPolicy>();
         }
 
         return array;
@@ -631,23 +2047,19 @@ public:
      *
      * @returns The index of the first match. -1 if not found.
      * If the index is out of range -1 is returned the the last error is set to INDEX_OUT_OF_RANGE.
+     * With a simdEq predicate the range is searched with vector instructions instead of calling the predicate.
      */
     template <class Predicate> ssize_t findIndex(size_t start, size_t count, const Predicate &p)
     {
         size_t end = start + count;
 
-        if ((start >= n) || (end > n))
+        if (ErrorPolicy::checkBounds && ((start >= n) || (end > n)))
         {
-            errorCb(DynArrayError::INDEX_OUT_OF_RANGE, errorCbCtx);
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
             return -1;
         }
 
-        for (size_t i = start; i < end; i++)
-        {
-            if (p(buf[i])) return i;
-        }
-
-        return -1;
+        return scanFirst(start, end, p);
     }
 
     /**
@@ -711,25 +2123,19 @@ public:
      *
      * @returns The index of the first match. -1 if not found.
      * If the index is out of range -1 is returned the the last error is set to INDEX_OUT_OF_RANGE.
+     * With a simdEq predicate the range is searched with vector instructions instead of calling the predicate.
      */
     template <class Predicate> ssize_t findLastIndex(size_t start, size_t count, const Predicate &p)
     {
         size_t end = start + count;
 
-        if ((start >= n) || (end > n))
+        if (ErrorPolicy::checkBounds && ((start >= n) || (end > n)))
         {
-            errorCb(DynArrayError::INDEX_OUT_OF_RANGE, errorCbCtx);
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
             return -1;
         }
 
-        size_t i = end;
-
-        while (i --> 0)
-        {
-            if (p(buf[i])) return i;
-        }
-
-        return -1;
+        return scanLast(start, end, p);
     }
 
 
@@ -783,6 +2189,7 @@ public:
     /**
      * Returns a part of the array.
      *
+     * @tparam RAlloc The allocator type of the new array. Defaults to the allocator of this array.
      * @param [in] start The start index the extraction starts at.
      * @param [in] count The count of elements to extract.
      * @param [in] alloc An instance of the allocator to be used in the new array.
@@ -790,28 +2197,25 @@ public:
      * @returns The new array that contains the subset of elements. The elements are copied (to avoid copy use pointers or smart pointers as T).
      *      Or error an empty array is returned. Check getLastError() to find out the reason of the failure.
      */
-    DynArray<T, Alloc> getRange(size_t start, size_t count, Alloc alloc = Alloc())
+    template <class RAlloc = Alloc>
+    DynArray<T, RAlloc, GrowthPolicy, ErrorPolicy> getRange(size_t start, size_t count, const RAlloc &alloc = RAlloc())
     {
-        DynArray<T, Alloc> range(alloc);
+        DynArray<T, RAlloc, GrowthPolicy, ErrorPolicy> range(alloc);
         size_t end = start + count;
 
-        if ((start >= n) || (end > n))
+        if (ErrorPolicy::checkBounds && ((start >= n) || (end > n)))
         {
-            errorCb(DynArrayError::INDEX_OUT_OF_RANGE, errorCbCtx);
-            return DynArray<T, Alloc>();
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
+            return DynArray<T, RAlloc, GrowthPolicy, ErrorPolicy>();
         }
 
         if (range.setCapacity(count))
         {
-            return DynArray<T, Alloc>();
+            return DynArray<T, RAlloc, GrowthPolicy, ErrorPolicy>();
         }
 
-        size_t j = 0;
+        Relocator::copy(range.buf, buf + start, count);
         range.n = count;
-        for (size_t i = start; i < end; i++)
-        {
-            range.buf[j++] =  buf[i];
-        }
 
         return range;
     }
@@ -887,25 +2291,22 @@ public:
      * @returns The index of the element if it's found. -1 if not found.
      *      On an index out of range condition it returns -1 and sets the last error to INDEX_OUT_OF_RANGE.
      *
-     * @remarks T must support the operator ==.
+     * @remarks T must support the operator ==. Integer and floating point elements are compared with vector
+     *      instructions, see simdIndexOf.
      */
     ssize_t indexOf(const T &elem, size_t index, size_t count)
     {
         size_t end = index + count;
 
-        if ((index >= n) || (end > n))
+        if (ErrorPolicy::checkBounds && ((index >= n) || (end > n)))
         {
-            errorCb(DynArrayError::INDEX_OUT_OF_RANGE, errorCbCtx);
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
             return -1;
         }
 
-        for (size_t i = index; i < end; i++)
-        {
-            if (buf[i] == elem) return i;
-        }
+        ssize_t found = simdIndexOf(buf + index, count, elem);
 
-        return -1;
-        //return indexOf(elem, index, count, [](const T &x, const T &y){return x == y;});
+        return found < 0 ? -1 : index + found;
     }
 
 
@@ -940,9 +2341,62 @@ public:
     }
 
 
+    /**
+     * Returns the index of the last occurrence of the given element in the range.
+     *
+     * @param [in] elem The element to find.
+     * @param [in] index The start index of the range.
+     * @param [in] count The number of elements to scan.
+     * @returns The index of the element if it's found. -1 if not found.
+     *      On an index out of range condition it returns -1 and sets the last error to INDEX_OUT_OF_RANGE.
+     *
+     * @remarks T must support the operator ==.
+     */
+    ssize_t lastIndexOf(const T &elem, size_t index, size_t count)
+    {
+        size_t end = index + count;
+
+        if (ErrorPolicy::checkBounds && ((index >= n) || (end > n)))
+        {
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
+            return -1;
+        }
+
+        ssize_t found = simdLastIndexOf(buf + index, count, elem);
+
+        return found < 0 ? -1 : index + found;
+    }
+
+
+    /**
+     * Returns the index of the last occurrence of the given element.
+     *
+     * @param [in] elem The element to find.
+     * @returns The index of the element if it's found. -1 if not found.
+     *      On an index out of range condition it returns -1 and sets the last error to INDEX_OUT_OF_RANGE.
+     *
+     * @remarks T must support the operator ==.
+     */
+    ssize_t lastIndexOf(const T &elem)
+    {
+        return lastIndexOf(elem, 0, n);
+    }
+
+
 
 
 
 
 
 };
+
+/**
+ * A DynArray only holds a pointer to its buffer, so it can be relocated with memcpy unless its allocator stores the
+ * buffer inline or can't be relocated itself. Arrays of arrays grow with realloc this way.
+ */
+template <class T, class Alloc, class GrowthPolicy, class ErrorPolicy>
+struct DynArrayTriviallyRelocatable<DynArray<T, Alloc, GrowthPolicy, ErrorPolicy>>
+    : std::integral_constant<bool, !DynArrayAllocTraits<T, Alloc>::HasIsInline::value &&
+        DynArrayTriviallyRelocatable<Alloc>::value && DynArrayTriviallyRelocatable<ErrorPolicy>::value> {};
+
+#endif
@@ -0,0 +1,405 @@
+#ifdef BENCHMARK
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <malloc.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "benchmark.h"
+#include "dynamic_array.h"
+
+template <class T>
+struct Alloc
+{
+    T *allocate(size_t n) {return (T*)malloc(n * sizeof(T));}
+    T *reallocate(T* buf, size_t n) {return (T*)realloc(buf, n * sizeof(T)); }
+    void deallocate(T *buf) {free(buf);}
+    size_t usableSize(T *buf) {return malloc_usable_size(buf) / sizeof(T);}
+};
+
+/** Trivially copyable record, takes the memcpy/realloc path. */
+struct Pod
+{
+    uint64_t a, b;
+};
+
+/** The same record with a user provided copy constructor, takes the element by element path. */
+struct NonTrivial
+{
+    uint64_t a, b;
+
+    NonTrivial(const Pod &p) : a(p.a), b(p.b) {}
+    NonTrivial(const NonTrivial &other) : a(other.a), b(other.b) {}
+};
+
+static const size_t N = 64 * 1024;
+static const int REPEATS = 500;
+
+template <class T> static void benchCopy(const char *name)
+{
+    DynArray<T, Alloc<T>> src;
+
+    for (size_t i = 0; i < N; i++) src.add(Pod{i, i});
+
+    double start = benchNow();
+    for (int r = 0; r < REPEATS; r++)
+    {
+        DynArray<T, Alloc<T>> copy = src;
+        benchKeep(copy.begin()[N - 1]);
+    }
+    benchReport(name, benchNow() - start, N * REPEATS);
+}
+
+template <class T> static void benchGrowth(const char *name)
+{
+    double start = benchNow();
+    for (int r = 0; r < REPEATS; r++)
+    {
+        DynArray<T, Alloc<T>> arr;
+
+        for (size_t i = 0; i < N; i++) arr.add(Pod{i, i});
+        benchKeep(arr.begin()[N - 1]);
+    }
+    benchReport(name, benchNow() - start, N * REPEATS);
+}
+
+template <class T> static void benchClear(const char *name)
+{
+    DynArray<T, Alloc<T>> arr;
+    double elapsed = 0;
+
+    for (int r = 0; r < REPEATS; r++)
+    {
+        for (size_t i = 0; i < N; i++) arr.add(Pod{i, i});
+
+        double start = benchNow();
+        arr.clear();
+        elapsed += benchNow() - start;
+    }
+    benchReport(name, elapsed, N * REPEATS);
+}
+
+/**
+ * Builds a 64K element array from a source buffer with per element adds, addRange, addN and appendUninitialized.
+ */
+static void benchBulkAppend()
+{
+    static uint32_t src[N];
+
+    for (size_t i = 0; i < N; i++) src[i] = (uint32_t)i;
+
+    double start = benchNow();
+    for (int r = 0; r < REPEATS; r++)
+    {
+        DynArray<uint32_t, Alloc<uint32_t>> arr;
+
+        for (size_t i = 0; i < N; i++) arr.add(src[i]);
+        benchKeep(arr.begin()[N - 1]);
+    }
+    benchReport("append 64K, add per element", benchNow() - start, N * REPEATS);
+
+    start = benchNow();
+    for (int r = 0; r < REPEATS; r++)
+    {
+        DynArray<uint32_t, Alloc<uint32_t>> arr;
+
+        arr.addRange(src, src + N);
+        benchKeep(arr.begin()[N - 1]);
+    }
+    benchReport("append 64K, addRange", benchNow() - start, N * REPEATS);
+
+    start = benchNow();
+    for (int r = 0; r < REPEATS; r++)
+    {
+        DynArray<uint32_t, Alloc<uint32_t>> arr;
+
+        arr.addN(N, (uint32_t)r);
+        benchKeep(arr.begin()[N - 1]);
+    }
+    benchReport("append 64K, addN", benchNow() - start, N * REPEATS);
+
+    start = benchNow();
+    for (int r = 0; r < REPEATS; r++)
+    {
+        DynArray<uint32_t, Alloc<uint32_t>> arr;
+
+        // Like a reader filling the array in 4K element chunks.
+        for (size_t i = 0; i < N; i += 4096)
+        {
+            memcpy(arr.appendUninitialized(4096), src + i, 4096 * sizeof(uint32_t));
+        }
+        benchKeep(arr.begin()[N - 1]);
+    }
+    benchReport("append 64K, appendUninitialized 4K chunks", benchNow() - start, N * REPEATS);
+}
+
+/**
+ * Removes and reinserts an element in the middle of a 4K element array, with removeAt/insertAt and by rebuilding
+ * the array from getRange pieces.
+ */
+static void benchPositional()
+{
+    const size_t count = 4096;
+    const int repeats = REPEATS * 20;
+    DynArray<uint32_t, Alloc<uint32_t>> arr;
+
+    for (size_t i = 0; i < count; i++) arr.add((uint32_t)i);
+
+    double start = benchNow();
+    for (int r = 0; r < repeats; r++)
+    {
+        size_t index = (r * 997) % count;
+        uint32_t value = arr[index];
+
+        arr.removeAt(index);
+        arr.insertAt(count / 2, value);
+    }
+    benchReport("remove + insert in 4K, removeAt/insertAt", benchNow() - start, repeats);
+    benchKeep(arr[0]);
+
+    start = benchNow();
+    for (int r = 0; r < repeats; r++)
+    {
+        size_t index = (r * 997) % count;
+        uint32_t value = arr[index];
+        DynArray<uint32_t, Alloc<uint32_t>> rebuilt = arr.getRange(0, index);
+        DynArray<uint32_t, Alloc<uint32_t>> tail = arr.getRange(index + 1, count - index - 1);
+
+        for (uint32_t x : tail) rebuilt.add(x);
+        arr = rebuilt.getRange(0, count / 2);
+        arr.add(value);
+        tail = rebuilt.getRange(count / 2, count - 1 - count / 2);
+        for (uint32_t x : tail) arr.add(x);
+    }
+    benchReport("remove + insert in 4K, getRange rebuild", benchNow() - start, repeats);
+    benchKeep(arr[0]);
+}
+
+/**
+ * Sums the array through operator[] in a tight loop, to compare the cost of the bounds checks and the error reporting
+ * of each error policy.
+ */
+template <class ErrorPolicy> static void benchIndexing(const char *name)
+{
+    DynArray<uint32_t, Alloc<uint32_t>, DynArrayDoublingGrowth, ErrorPolicy> arr;
+
+    for (size_t i = 0; i < N; i++) arr.add((uint32_t)i);
+
+    uint32_t sum = 0;
+    double start = benchNow();
+    for (int r = 0; r < REPEATS * 4; r++)
+    {
+        size_t count = arr.getCount();
+
+        benchKeep(count);
+        for (size_t i = 0; i < count; i++) sum += arr[i];
+    }
+    benchReport(name, benchNow() - start, N * REPEATS * 4);
+    benchKeep(sum);
+}
+
+/**
+ * Runs the measurement in a child process, so it starts on a fresh heap, then prints the peak RSS of the child.
+ *
+ * @param[in] name The name of the measurement, printed if the child fails.
+ * @param[in] payloadBytes The size of the data the measurement works on, printed for reference.
+ * @param[in] measure A functor with the signature bool measure(), returns false on failure.
+ */
+template <class Measure> static void benchForked(const char *name, size_t payloadBytes, const Measure &measure)
+{
+    fflush(stdout);
+
+    pid_t pid = fork();
+
+    if (pid == 0)
+    {
+        bool ok = measure();
+
+        fflush(stdout);
+        _exit(ok ? 0 : 1);
+    }
+
+    int status;
+    struct rusage usage;
+
+    if ((pid < 0) || (wait4(pid, &status, 0, &usage) < 0) || !WIFEXITED(status) || WEXITSTATUS(status))
+    {
+        printf("%-48s failed\n", name);
+        return;
+    }
+
+    printf("%-48s %10.1f MB peak RSS (payload %.1f MB)\n", "", usage.ru_maxrss / 1024.0, payloadBytes / 1048576.0);
+}
+
+/**
+ * Grows an array of 8 byte elements to the given size and reports the time and the peak RSS, so each policy is
+ * measured on a fresh heap.
+ *
+ * Note that glibc's realloc grows large blocks with mremap, so the peak mostly reflects the unused capacity here.
+ */
+template <class GrowthPolicy> static void benchGrowthPolicy(const char *name, size_t count)
+{
+    benchForked(name, count * 8, [name, count]() {
+        DynArray<uint64_t, Alloc<uint64_t>, GrowthPolicy> arr;
+
+        double start = benchNow();
+        for (size_t i = 0; i < count; i++)
+        {
+            if (arr.add(i)) return false;
+        }
+        benchReport(name, benchNow() - start, count);
+
+        return true;
+    });
+}
+
+/**
+ * Drops about half of the elements of a large array by a pseudo random predicate, in place with removeIf and by
+ * swapping in the result of findAll. Reports the time and the peak RSS.
+ */
+template <bool InPlace> static void benchFilter(const char *name, size_t count)
+{
+    benchForked(name, count * 4, [name, count]() {
+        DynArray<uint32_t, Alloc<uint32_t>> arr;
+
+        if (arr.addN(count, 0)) return false;
+        for (size_t i = 0; i < count; i++) arr[i] = (uint32_t)(i * 2654435761u);
+
+        auto odd = [](uint32_t x) {return (x >> 16) & 1;};
+
+        double start = benchNow();
+        if (InPlace)
+        {
+            arr.removeIf(odd);
+        }
+        else
+        {
+            arr = arr.findAll([&odd](uint32_t x) {return !odd(x);});
+        }
+        benchReport(name, benchNow() - start, count);
+        benchKeep(arr[0]);
+
+        return arr.isAlive();
+    });
+}
+
+/** Three way comparator for the search benchmarks. */
+struct CompareU32
+{
+    int operator()(uint32_t a, uint32_t b) const {return (a > b) - (a < b);}
+};
+
+/**
+ * The three way branching binary search binarySearch used before it became branchless, for comparison.
+ */
+static bool branchingBinarySearch(const uint32_t *buf, size_t length, uint32_t elem)
+{
+    size_t left = 0;
+    size_t right = length;
+    CompareU32 c;
+
+    while (left < right)
+    {
+        size_t mid = left + (right - left) / 2;
+        int comparison = c(elem, buf[mid]);
+
+        if (comparison == 0) return true;
+
+        if (comparison < 0)
+        {
+            right = mid;
+        }
+        else
+        {
+            left = mid + 1;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Looks up random keys in a sorted array of the given size, with the old and the current binarySearch and with
+ * binarySearchBatch. Half of the keys are present. The sizes are picked to fit the levels of the cache hierarchy.
+ */
+static void benchBinarySearch(const char *level, size_t count)
+{
+    const size_t lookups = 4 * 1024 * 1024;
+    DynArray<uint32_t, Alloc<uint32_t>> arr;
+    DynArray<uint32_t, Alloc<uint32_t>> keys;
+
+    if (!arr.appendUninitialized(count) || !keys.appendUninitialized(lookups)) return;
+    for (size_t i = 0; i < count; i++) arr[i] = (uint32_t)(i * 2);
+
+    uint64_t state = 88172645463325252ull;
+    for (size_t i = 0; i < lookups; i++)
+    {
+        state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+        keys[i] = (uint32_t)(state % (count * 2));
+    }
+
+    char name[64];
+    size_t found = 0;
+
+    snprintf(name, sizeof(name), "binarySearch %s, branching", level);
+    double start = benchNow();
+    for (size_t i = 0; i < lookups; i++) found += branchingBinarySearch(arr.begin(), count, keys[i]);
+    benchReport(name, benchNow() - start, lookups);
+
+    snprintf(name, sizeof(name), "binarySearch %s, branchless", level);
+    start = benchNow();
+    for (size_t i = 0; i < lookups; i++) found += arr.binarySearch<CompareU32>(keys[i]);
+    benchReport(name, benchNow() - start, lookups);
+
+    // Batches of 1024 keys, so the flags stay in the cache.
+    static bool flags[1024];
+
+    snprintf(name, sizeof(name), "binarySearch %s, batched", level);
+    start = benchNow();
+    for (size_t i = 0; i < lookups; i += 1024)
+    {
+        arr.binarySearchBatch<CompareU32>(keys.begin() + i, 1024, flags);
+        for (size_t j = 0; j < 1024; j++) found += flags[j];
+    }
+    benchReport(name, benchNow() - start, lookups);
+
+    benchKeep(found);
+}
+
+int main()
+{
+    benchCopy<Pod>("copy construct, trivially copyable");
+    benchCopy<NonTrivial>("copy construct, non-trivial");
+    benchGrowth<Pod>("add with growth, trivially copyable");
+    benchGrowth<NonTrivial>("add with growth, non-trivial");
+    benchClear<Pod>("clear, trivially destructible");
+    benchBulkAppend();
+    benchPositional();
+
+    benchIndexing<DynArrayRuntimeErrors>("indexing loop, runtime callback");
+    benchIndexing<DynArrayIgnoreErrors>("indexing loop, checked, ignore errors");
+    benchIndexing<DynArrayAbortOnError>("indexing loop, abort on error");
+    benchIndexing<DynArrayUnchecked>("indexing loop, unchecked");
+
+    const size_t growCount = 48 * 1024 * 1024;
+    benchGrowthPolicy<DynArrayDoublingGrowth>("grow 384 MB, doubling", growCount);
+    benchGrowthPolicy<DynArrayGoldenGrowth>("grow 384 MB, 1.5x", growCount);
+    benchGrowthPolicy<DynArrayLinearGrowth<64 * 1024 * 1024>>("grow 384 MB, 64 MB chunks", growCount);
+    benchGrowthPolicy<DynArraySizeClassGrowth<DynArrayGoldenGrowth>>("grow 384 MB, 1.5x size classes", growCount);
+
+    const size_t filterCount = 64 * 1024 * 1024;
+    benchFilter<true>("filter 256 MB, removeIf", filterCount);
+    benchFilter<false>("filter 256 MB, findAll and swap", filterCount);
+
+    benchBinarySearch("16 KB (L1)", 4 * 1024);
+    benchBinarySearch("1 MB (L2)", 256 * 1024);
+    benchBinarySearch("64 MB (L3)", 16 * 1024 * 1024);
+    benchBinarySearch("1 GB (DRAM)", 256 * 1024 * 1024);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,148 @@
+#ifdef UNIT_TEST
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include <string>
+
+#include "eytzinger_index.h"
+
+template <class T>
+struct Alloc
+{
+    T *allocate(size_t n) {return (T*)malloc(n * sizeof(T));}
+    T *reallocate(T* buf, size_t n) {return (T*)realloc((void*)buf, n * sizeof(T)); }
+    void deallocate(T *buf) {free(buf);}
+};
+
+/** Allocator that always fails. */
+template <class T>
+struct FailingAlloc
+{
+    T *allocate(size_t) {return nullptr;}
+    T *reallocate(T*, size_t) {return nullptr;}
+    void deallocate(T *) {}
+};
+
+/** Three way comparator for arrays sorted in descending order. */
+struct Descending
+{
+    int operator()(int a, int b) const {return (a < b) - (a > b);}
+};
+
+DynArrayError theError;
+
+void errorCallback(DynArrayError error, void *context)
+{
+    theError = error;
+    (void)context;
+}
+
+int main()
+{
+    {
+        // Every size up to 300, including the ones that fill the tree exactly, against DynArray::lowerBound.
+        for (size_t count = 0; count <= 300; count++)
+        {
+            DynArray<int, Alloc<int>> sorted;
+            DynArray<int, Alloc<int>> descending;
+            EytzingerIndex<int, Alloc<int>> index;
+            EytzingerIndex<int, Alloc<int>> descendingIndex;
+
+            for (size_t i = 0; i < count; i++)
+            {
+                assert(!sorted.add((int)(i / 2 * 3)));
+                assert(!descending.add(-(int)(i / 2 * 3)));
+            }
+
+            assert(!index.build(sorted));
+            assert(!descendingIndex.build(descending));
+            assert(index.getCount() == count);
+
+            for (int key = -2; key <= (int)(count / 2 * 3) + 2; key++)
+            {
+                assert(index.lowerBound(key) == sorted.lowerBound(key));
+                assert(index.contains(key) == sorted.binarySearch(key));
+                assert(descendingIndex.lowerBound<Descending>(-key) == sorted.lowerBound(key));
+                assert(descendingIndex.contains<Descending>(-key) == sorted.binarySearch(key));
+            }
+        }
+    }
+
+    {
+        // Wide elements, prefetching a single level down.
+        struct Wide
+        {
+            uint64_t key;
+            char payload[120];
+
+            bool operator==(const Wide &other) const {return key == other.key;}
+            bool operator<(const Wide &other) const {return key < other.key;}
+        };
+
+        DynArray<Wide, Alloc<Wide>> sorted;
+        EytzingerIndex<Wide, Alloc<Wide>> index;
+
+        for (uint64_t i = 0; i < 1000; i++) assert(!sorted.add(Wide{i * 2, {0}}));
+        assert(!index.build(sorted));
+
+        for (uint64_t key = 0; key < 2000; key++)
+        {
+            assert(index.lowerBound(Wide{key, {0}}) == (ssize_t)((key + 1) / 2));
+            assert(index.contains(Wide{key, {0}}) == (key % 2 == 0));
+        }
+
+        assert(index.lowerBound(Wide{2000, {0}}) == 1000);
+        assert(!index.contains(Wide{2000, {0}}));
+    }
+
+    {
+        // Non-trivial elements are copied into the tree and destroyed with it.
+        DynArray<std::string, Alloc<std::string>> words;
+        EytzingerIndex<std::string, Alloc<std::string>> index;
+        const char *sortedWords[] = {"apple", "banana", "cherry", "date", "elderberry", "fig", "grape"};
+
+        for (const char *word : sortedWords) assert(!words.add(std::string(word)));
+
+        assert(!index.build(words));
+        assert(!index.build(words)); // Rebuilding releases the previous tree.
+        words.clear();
+
+        assert(index.contains(std::string("cherry")));
+        assert(!index.contains(std::string("coconut")));
+        assert(index.lowerBound(std::string("coconut")) == 3);
+        assert(index.lowerBound(std::string("zucchini")) == 7);
+
+        EytzingerIndex<std::string, Alloc<std::string>> moved(static_cast<EytzingerIndex<std::string, Alloc<std::string>>&&>(index));
+        assert(moved.contains(std::string("grape")));
+        assert(index.getCount() == 0);
+        assert(!index.contains(std::string("grape")));
+        assert(index.lowerBound(std::string("grape")) == 0);
+
+        index = static_cast<EytzingerIndex<std::string, Alloc<std::string>>&&>(moved);
+        assert(index.contains(std::string("fig")));
+    }
+
+    {
+        // Allocation failure.
+        DynArray<int, Alloc<int>> sorted;
+        EytzingerIndex<int, FailingAlloc<int>> index;
+
+        index.setErrorCb(errorCallback, nullptr);
+        assert(!index.build(sorted)); // Empty, doesn't allocate.
+
+        assert(!sorted.add(1));
+        theError = DynArrayError::OK;
+        assert(index.build(sorted));
+        assert(theError == DynArrayError::ALLOCATION_FAILURE);
+        assert(index.getCount() == 0);
+        assert(!index.contains(1));
+    }
+
+    printf("Passed: %s %s\n", __DATE__, __TIME__);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,261 @@
+#ifndef EYTZINGER_INDEX_H
+#define EYTZINGER_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <new>
+
+#include "dynamic_array.h"
+
+/**
+ * Read-only search index over a sorted array in Eytzinger (breadth first) order.
+ *
+ * The elements are stored as an implicit binary search tree: the root is at 1, the children of k at 2k and 2k + 1.
+ * The first levels of the tree share a few cache lines that stay cached between lookups, and the descendants of a
+ * node a few levels down are adjacent, so they can be prefetched with a single instruction long before they are
+ * needed. A binary search over the sorted array jumps across the whole buffer instead and misses cache on most
+ * steps.
+ *
+ * The tree is padded to a perfect one with copies of the last element. So each lookup takes the same number of
+ * steps without branching, and the path taken is the number of elements less than the searched one, which gives
+ * the index in the original array directly. The price is up to twice the memory of the sorted array.
+ *
+ * Example:
+ *
+ *   EytzingerIndex<uint32_t, Alloc<uint32_t>> index;
+ *
+ *   if (index.build(sortedKeys)) return -1;
+ *   ssize_t i = index.lowerBound(key); // Same as sortedKeys.lowerBound(key).
+ *
+ * @tparam T The type of elements.
+ * @tparam Alloc The allocator used to allocate the tree.
+ * @tparam ErrorPolicy Decides how errors are handled. See DynArrayRuntimeErrors.
+ */
+template <class T, class Alloc, class ErrorPolicy = DynArrayRuntimeErrors>
+class EytzingerIndex : public ErrorPolicy
+{
+    /** Rounds down to a power of two. */
+    static constexpr size_t floorPow2(size_t x) {return x <= 1 ? 1 : 2 * floorPow2(x / 2);}
+    static constexpr unsigned log2(size_t x) {return x <= 1 ? 0 : 1 + log2(x / 2);}
+
+    /**
+     * The descendants of node k prefetchLevels levels down are at [k * prefetchStride, (k + 1) * prefetchStride),
+     * one cache line.
+     */
+    // @{
+    static const size_t prefetchStride = 64 / sizeof(T) >= 2 ? floorPow2(64 / sizeof(T)) : 2;
+    static const unsigned prefetchLevels = log2(prefetchStride);
+    // @}
+
+    T *mem = nullptr; ///< The allocated buffer.
+    T *tree = nullptr; ///< The tree, the root is at tree[1]. Aligned to a cache line where possible.
+    size_t n = 0; ///< The number of elements in the original array.
+    size_t size = 0; ///< The number of nodes, 2^height - 1.
+    unsigned height = 0; ///< The number of levels.
+    Alloc ator; ///< An instance of the allocator.
+
+    typedef DynArrayRelocator<T> Relocator;
+
+    /**
+     * @returns The node holding the element with the given index in the padded sorted order.
+     */
+    size_t nodeOf(size_t index) const
+    {
+        unsigned zeros = __builtin_ctzll(index + 1);
+
+        return ((size_t)1 << (height - 1 - zeros)) + ((index + 1) >> (zeros + 1));
+    }
+
+    /**
+     * Releases the tree.
+     */
+    void destruct()
+    {
+        if (mem == nullptr) return;
+
+        Relocator::destroy(tree + 1, size);
+        ator.deallocate(mem);
+        mem = nullptr;
+        tree = nullptr;
+        n = 0;
+        size = 0;
+        height = 0;
+    }
+
+    /**
+     * Takes over the tree of another index.
+     */
+    void moveFrom(EytzingerIndex<T, Alloc, ErrorPolicy> &&other)
+    {
+        mem = other.mem;
+        tree = other.tree;
+        n = other.n;
+        size = other.size;
+        height = other.height;
+        ator = other.ator;
+        static_cast<ErrorPolicy&>(*this) = other;
+
+        other.mem = nullptr;
+        other.tree = nullptr;
+        other.n = 0;
+        other.size = 0;
+        other.height = 0;
+    }
+
+public:
+
+    /**
+     * Initializes an empty index.
+     *
+     * @param[in] alloc An instance of the allocator used to allocate the tree.
+     */
+    EytzingerIndex(const Alloc &alloc = Alloc()) : ator(alloc) {}
+
+    /**
+     * Destructor. Releases the memory.
+     */
+    ~EytzingerIndex() {destruct();}
+
+    EytzingerIndex(const EytzingerIndex<T, Alloc, ErrorPolicy> &) = delete;
+    EytzingerIndex<T, Alloc, ErrorPolicy>& operator=(const EytzingerIndex<T, Alloc, ErrorPolicy> &) = delete;
+
+    /**
+     * Move constructor. The source index will be empty.
+     */
+    EytzingerIndex(EytzingerIndex<T, Alloc, ErrorPolicy> &&other)
+    {
+        moveFrom(static_cast<EytzingerIndex<T, Alloc, ErrorPolicy>&&>(other));
+    }
+
+    /**
+     * Move assignment operator. The source index will be empty.
+     */
+    EytzingerIndex<T, Alloc, ErrorPolicy>& operator=(EytzingerIndex<T, Alloc, ErrorPolicy> &&other)
+    {
+        if (this == &other) return *this;
+
+        destruct();
+        moveFrom(static_cast<EytzingerIndex<T, Alloc, ErrorPolicy>&&>(other));
+
+        return *this;
+    }
+
+    /**
+     * Builds the index from a sorted array in O(n), replacing the previous contents.
+     *
+     * The elements are copied, the index doesn't refer to the array afterwards.
+     *
+     * @param[in] sorted The array, sorted by the comparator the index will be searched with.
+     * @returns Zero on success, non-zero on failure.
+     *
+     * @remarks
+     *    If we run out of memory the ALLOCATION_FAILURE error is set and the index is left empty.
+     */
+    template <class A, class G, class E> int build(const DynArray<T, A, G, E> &sorted)
+    {
+        const T *src = sorted.begin();
+        size_t count = sorted.end() - src;
+
+        destruct();
+
+        if (count == 0) return 0;
+
+        unsigned levels = 1;
+        while ((((size_t)1 << levels) - 1) < count) levels++;
+
+        size_t nodes = ((size_t)1 << levels) - 1;
+
+        if (nodes > SIZE_MAX / sizeof(T) - 1 - prefetchStride)
+        {
+            this->reportError(DynArrayError::ALLOCATION_FAILURE);
+            return -1;
+        }
+
+        mem = ator.allocate(nodes + 1 + prefetchStride);
+        if (mem == nullptr)
+        {
+            this->reportError(DynArrayError::ALLOCATION_FAILURE);
+            return -1;
+        }
+
+        // Start the tree at a cache line, so the prefetched descendants don't straddle two lines.
+        size_t offset = 0;
+        while ((offset < prefetchStride) && ((uintptr_t)(mem + offset) % 64 != 0)) offset++;
+        if (offset == prefetchStride) offset = 0;
+
+        tree = mem + offset;
+        n = count;
+        size = nodes;
+        height = levels;
+
+        for (size_t i = 0; i < nodes; i++) new (tree + nodeOf(i)) T(src[i < count ? i : count - 1]);
+
+        return 0;
+    }
+
+    /**
+     * Finds the first element that is not less than the given one.
+     *
+     * @tparam Compare Three way comparator, see DynArray::binarySearch.
+     *
+     * @param[in] elem The element to search for.
+     * @returns The index of the element in the array the index was built from, getCount() if there is none.
+     */
+    // @{
+    template <typename Compare> ssize_t lowerBound(const T &elem) const
+    {
+        Compare c;
+        size_t k = 1;
+        unsigned level = 0;
+
+        for (; level + prefetchLevels < height; level++)
+        {
+            __builtin_prefetch(tree + k * prefetchStride);
+            k = 2 * k + (c(tree[k], elem) < 0);
+        }
+
+        for (; level < height; level++) k = 2 * k + (c(tree[k], elem) < 0);
+
+        // The path taken, k without its leading bit, is the number of nodes less than elem.
+        size_t index = k - (size + 1);
+
+        return index < n ? index : n;
+    }
+
+    ssize_t lowerBound(const T &elem) const
+    {
+        return lowerBound<DynArrayCompare<T>>(elem);
+    }
+    // @}
+
+    /**
+     * Checks if the element is in the index.
+     *
+     * @tparam Compare Three way comparator, see DynArray::binarySearch.
+     *
+     * @param[in] elem The element to search for.
+     * @returns True if the element is found.
+     */
+    // @{
+    template <typename Compare> bool contains(const T &elem) const
+    {
+        size_t index = lowerBound<Compare>(elem);
+
+        return (index < n) && (Compare()(tree[nodeOf(index)], elem) == 0);
+    }
+
+    bool contains(const T &elem) const
+    {
+        return contains<DynArrayCompare<T>>(elem);
+    }
+    // @}
+
+    /**
+     * @returns The number of elements in the array the index was built from.
+     */
+    size_t getCount() const {return n;}
+};
+
+#endif
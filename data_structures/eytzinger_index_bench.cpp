@@ -0,0 +1,69 @@
+#ifdef BENCHMARK
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "benchmark.h"
+#include "eytzinger_index.h"
+
+template <class T>
+struct Alloc
+{
+    T *allocate(size_t n) {return (T*)malloc(n * sizeof(T));}
+    T *reallocate(T* buf, size_t n) {return (T*)realloc(buf, n * sizeof(T));}
+    void deallocate(T *buf) {free(buf);}
+};
+
+/**
+ * Looks up random keys with lowerBound on a sorted array and on an index built from it. The sizes are picked to
+ * fit the levels of the cache hierarchy.
+ */
+static void benchLowerBound(const char *level, size_t count)
+{
+    const size_t lookups = 4 * 1024 * 1024;
+    DynArray<uint32_t, Alloc<uint32_t>> sorted;
+    DynArray<uint32_t, Alloc<uint32_t>> keys;
+    EytzingerIndex<uint32_t, Alloc<uint32_t>> index;
+
+    if (!sorted.appendUninitialized(count) || !keys.appendUninitialized(lookups)) return;
+    for (size_t i = 0; i < count; i++) sorted[i] = (uint32_t)(i * 2);
+
+    uint64_t state = 88172645463325252ull;
+    for (size_t i = 0; i < lookups; i++)
+    {
+        state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+        keys[i] = (uint32_t)(state % (count * 2));
+    }
+
+    char name[64];
+    size_t sum = 0;
+
+    snprintf(name, sizeof(name), "build %s", level);
+    double start = benchNow();
+    if (index.build(sorted)) return;
+    benchReport(name, benchNow() - start, count);
+
+    snprintf(name, sizeof(name), "lowerBound %s, sorted array", level);
+    start = benchNow();
+    for (size_t i = 0; i < lookups; i++) sum += sorted.lowerBound(keys[i]);
+    benchReport(name, benchNow() - start, lookups);
+
+    snprintf(name, sizeof(name), "lowerBound %s, Eytzinger", level);
+    start = benchNow();
+    for (size_t i = 0; i < lookups; i++) sum -= index.lowerBound(keys[i]);
+    benchReport(name, benchNow() - start, lookups);
+
+    if (sum != 0) printf("Results differ!\n");
+}
+
+int main()
+{
+    benchLowerBound("16 KB (L1)", 4 * 1024);
+    benchLowerBound("1 MB (L2)", 256 * 1024);
+    benchLowerBound("64 MB (L3)", 16 * 1024 * 1024);
+    benchLowerBound("1 GB (DRAM)", 256 * 1024 * 1024);
+
+    return 0;
+}
+
+#endif
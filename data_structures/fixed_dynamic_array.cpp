@@ -0,0 +1,125 @@
+#ifdef UNIT_TEST
+#include <stdio.h>
+#include <assert.h>
+
+#include "fixed_dynamic_array.h"
+
+DynArrayError theError;
+
+void errorCallback(DynArrayError error, void *context)
+{
+    theError = error;
+    (void)context;
+}
+
+struct Squares
+{
+    constexpr int operator()(size_t i) const {return (int)(i * i);}
+};
+
+constexpr FixedDynArray<int, 8> primes(2, 3, 5, 7, 11, 13);
+constexpr FixedDynArray<int, 64> squares = FixedDynArray<int, 64>::generate<64>(Squares());
+
+static_assert(primes.getCount() == 6, "count");
+static_assert(primes.getCapacity() == 8, "capacity");
+static_assert(primes[3] == 7, "element access");
+static_assert(primes.binarySearch(11), "search hit");
+static_assert(!primes.binarySearch(4), "search miss");
+static_assert(!FixedDynArray<int, 4>().binarySearch(4), "search empty");
+static_assert(squares[63] == 63 * 63, "generated");
+static_assert(squares.binarySearch(49 * 49), "generated search");
+
+constexpr FixedDynArray<int, 4, DynArrayUnchecked> uncheckedTable(1, 2, 3);
+static_assert(uncheckedTable[2] == 3, "unchecked element access");
+static_assert(sizeof(uncheckedTable) == 4 * sizeof(int) + sizeof(size_t), "stateless policy takes no space");
+
+int main()
+{
+    FixedDynArray<int, 8> arr;
+    arr.setErrorCb(errorCallback, nullptr);
+
+    for (int i = 1; i <= 8; i++)
+    {
+        assert(!arr.add(i));
+    }
+    assert(arr.getCount() == 8);
+    assert(arr.add(9) == -1);
+    assert(theError == DynArrayError::CAPACITY_EXCEEDED);
+    theError = DynArrayError::OK;
+
+    int y = 1;
+    for (int x : arr)
+    {
+        assert(x == y);
+        y++;
+    }
+
+    assert(arr[0] == 1);
+    {
+        int &tmp = arr[8];
+        (void)tmp;
+        assert(theError == DynArrayError::INDEX_OUT_OF_RANGE);
+        theError = DynArrayError::OK;
+    }
+
+    assert(arr.binarySearch(5));
+    assert(!arr.binarySearch(9));
+
+    struct Compare
+    {
+        int operator()(const int &a, const int &b) const {return a - b;}
+    };
+    assert(arr.binarySearch<Compare>(8));
+    assert(!arr.binarySearch<Compare>(0));
+
+    assert(arr.contains(3));
+    assert(!arr.contains(10));
+    assert(arr.contains(3, [](int a, int b){return a == b;}));
+    assert(arr.indexOf(4) == 3);
+    assert(arr.indexOf(4, 4) == -1);
+    assert(theError == DynArrayError::OK);
+    assert(arr.indexOf(4, 7, 2) == -1);
+    assert(theError == DynArrayError::INDEX_OUT_OF_RANGE);
+    theError = DynArrayError::OK;
+
+    assert(arr.exists([](int x){return x > 7;}));
+    assert(!arr.exists([](int x){return x > 8;}));
+    assert(*arr.find([](int x){return x % 3 == 0;}) == 3);
+    assert(*arr.findLast([](int x){return x % 3 == 0;}) == 6);
+    assert(arr.findIndex([](int x){return x % 2 == 0;}) == 1);
+    assert(arr.findIndex(2, [](int x){return x % 2 == 0;}) == 3);
+    assert(arr.findLastIndex([](int x){return x % 2 == 0;}) == 7);
+    assert(arr.findLastIndex(2, 3, [](int x){return x == 2;}) == -1);
+    assert(arr.findLastIndex(0, 3, [](int x){return x % 2 == 0;}) == 1);
+    assert(arr.findIndex(8, [](int){return true;}) == -1);
+    assert(theError == DynArrayError::INDEX_OUT_OF_RANGE);
+    theError = DynArrayError::OK;
+
+    FixedDynArray<int, 8> odd = arr.findAll([](int x){return x % 2;});
+    assert(odd.getCount() == 4);
+    assert(odd[3] == 7);
+
+    arr.forEach([](int &x){x *= 10;});
+    assert(arr[7] == 80);
+
+    int out[10] = {0};
+    arr.copyTo(out, 1);
+    assert(out[0] == 0);
+    assert(out[1] == 10);
+    assert(out[8] == 80);
+
+    arr.clear();
+    assert(arr.getCount() == 0);
+    assert(arr.indexOf(10) == -1);
+    assert(arr.findIndex([](int){return true;}) == -1);
+    assert(theError == DynArrayError::OK);
+
+    assert(primes.contains(13));
+    assert(squares.indexOf(144) == 12);
+
+    printf("Passed: %s %s\n", __DATE__, __TIME__);
+
+    return 0;
+}
+
+#endif
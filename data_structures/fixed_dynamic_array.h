@@ -0,0 +1,404 @@
+#ifndef FIXED_DYNAMIC_ARRAY_H
+#define FIXED_DYNAMIC_ARRAY_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "dynamic_array.h"
+
+/** A compile time list of indices, used to expand generators. */
+template <size_t... I> struct FixedDynArrayIndices {};
+
+template <size_t Count, size_t... I>
+struct FixedDynArrayMakeIndices : FixedDynArrayMakeIndices<Count - 1, Count - 1, I...> {};
+
+template <size_t... I>
+struct FixedDynArrayMakeIndices<0, I...>
+{
+    typedef FixedDynArrayIndices<I...> Type;
+};
+
+/**
+ * Fixed capacity array with the storage inside the object.
+ *
+ * Has the search, find and forEach API of DynArray without an allocator: adding never allocates and never fails
+ * with ALLOCATION_FAILURE, only with CAPACITY_EXCEEDED when full.
+ *
+ * For literal types the array can be constructed and read in constant expressions, so lookup tables can be built at
+ * compile time and end up in read-only data:
+ *
+ *   constexpr FixedDynArray<int, 4> primes(2, 3, 5, 7);
+ *   static_assert(primes.binarySearch(5), "");
+ *
+ * @tparam T The type of elements. Must be default constructible, all N elements are constructed up front.
+ * @tparam N The capacity.
+ * @tparam ErrorPolicy Decides how errors are handled and whether bounds are checked. See DynArrayRuntimeErrors.
+ */
+template <class T, size_t N, class ErrorPolicy = DynArrayRuntimeErrors>
+class FixedDynArray : public ErrorPolicy
+{
+    T buf[N]; ///< The elements. Those at and beyond n are unused.
+    size_t n; ///< The number of elements in the array.
+
+    const T &outOfRange() const
+    {
+        this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
+        return *static_cast<const T*>(nullptr);
+    }
+
+    template <size_t... I, class Generator>
+    static constexpr FixedDynArray<T, N, ErrorPolicy> generate(FixedDynArrayIndices<I...>, const Generator &g)
+    {
+        return FixedDynArray<T, N, ErrorPolicy>(g(I)...);
+    }
+
+    constexpr bool binarySearch(const T &elem, size_t left, size_t right) const
+    {
+        return left >= right ? false :
+            buf[left + (right - left) / 2] == elem ? true :
+            buf[left + (right - left) / 2] < elem ? binarySearch(elem, left + (right - left) / 2 + 1, right) :
+                binarySearch(elem, left, left + (right - left) / 2);
+    }
+
+public:
+    /**
+     * Creates an empty array.
+     */
+    constexpr FixedDynArray() : ErrorPolicy(), buf(), n(0) {}
+
+    /**
+     * Creates an array from the given elements.
+     */
+    template <class... Rest>
+    constexpr explicit FixedDynArray(const T &first, const Rest&... rest)
+        : ErrorPolicy(), buf{first, rest...}, n(1 + sizeof...(Rest))
+    {
+        static_assert(1 + sizeof...(Rest) <= N, "Too many elements for the capacity.");
+    }
+
+    /**
+     * Creates an array of Count elements, each computed by the generator.
+     *
+     * @tparam Count The number of elements, at most N.
+     * @param[in] g A functor with the signature T generator(size_t index). Must be a literal type with a constexpr
+     *      call operator to use this in a constant expression.
+     */
+    template <size_t Count, class Generator> static constexpr FixedDynArray<T, N, ErrorPolicy> generate(const Generator &g)
+    {
+        static_assert((Count > 0) && (Count <= N), "Count must be between 1 and the capacity.");
+
+        return generate(typename FixedDynArrayMakeIndices<Count>::Type(), g);
+    }
+
+    // Iterators (for range based for loop)
+
+    const T *begin() const {return buf;}
+    T *begin() {return buf;}
+    T *end() {return buf + n;}
+    const T *end() const {return buf + n;}
+
+    // Operations
+
+    /**
+     * Queries the element at the given index.
+     *
+     * @remarks
+     *  On out of bounds access the INDEX_OUT_OF_RANGE error will be set and the operator returns
+     *  a nullptr reference. In a constant expression that's a compile error.
+     */
+    // @{
+    constexpr const T& operator[](size_t index) const
+    {
+        return !ErrorPolicy::checkBounds || (index < n) ? buf[index] : outOfRange();
+    }
+    T& operator[](size_t index)
+    {
+        return !ErrorPolicy::checkBounds || (index < n) ? buf[index] : const_cast<T&>(outOfRange());
+    }
+    // @}
+
+    /**
+     * @returns The number of elements in the array.
+     */
+    constexpr size_t getCount() const {return n;}
+
+    /**
+     * @returns The number of elements the array can hold.
+     */
+    static constexpr size_t getCapacity() {return N;}
+
+    /**
+     * Adds an element to the array.
+     *
+     * @returns Zero on success, -1 with CAPACITY_EXCEEDED if the array is full.
+     */
+    int add(const T &elem)
+    {
+        if (n >= N)
+        {
+            this->reportError(DynArrayError::CAPACITY_EXCEEDED);
+            return -1;
+        }
+
+        buf[n++] = elem;
+
+        return 0;
+    }
+
+    /**
+     * Removes all elements. The storage of the elements is kept, so this doesn't run destructors.
+     */
+    void clear() {n = 0;}
+
+    /**
+     * Performs binary search. The array must be sorted and T must support the == and < operators.
+     *
+     * @returns true if the element is found.
+     */
+    constexpr bool binarySearch(const T &elem) const {return binarySearch(elem, 0, n);}
+
+    /**
+     * Performs binary search in a sorted array.
+     *
+     * @tparam Compare Three way comparator, see DynArray::binarySearch.
+     * @returns true if the element is found.
+     */
+    template <typename Compare> bool binarySearch(const T &elem) const
+    {
+        size_t left = 0;
+        size_t right = n;
+        Compare c;
+
+        while (left < right)
+        {
+            size_t mid = left + (right - left) / 2;
+            int comparison = c(elem, buf[mid]);
+
+            if (comparison == 0) return true;
+
+            if (comparison < 0)
+            {
+                right = mid;
+            }
+            else
+            {
+                left = mid + 1;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Performs linear search with the given equality comparer.
+     *
+     * @returns true if the element is found.
+     */
+    template <class EqualityCompare> bool contains(const T &elem, const EqualityCompare &c) const
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            if (c(buf[i], elem)) return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * Performs linear search using the == operator.
+     *
+     * @returns true if the element is found.
+     */
+    bool contains(const T &elem) const
+    {
+        return indexOf(elem) >= 0;
+    }
+
+    /**
+     * Returns the index of the given element in the range.
+     *
+     * @returns The index of the element or -1 if not found. On out of range indices -1 with INDEX_OUT_OF_RANGE.
+     */
+    ssize_t indexOf(const T &elem, size_t index, size_t count) const
+    {
+        size_t end = index + count;
+
+        if (ErrorPolicy::checkBounds && ((index >= n) || (end > n)))
+        {
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
+            return -1;
+        }
+
+        for (size_t i = index; i < end; i++)
+        {
+            if (buf[i] == elem) return i;
+        }
+
+        return -1;
+    }
+
+    ssize_t indexOf(const T &elem, size_t index) const {return indexOf(elem, index, n - index);}
+
+    ssize_t indexOf(const T &elem) const
+    {
+        if (n == 0) return -1;
+
+        return indexOf(elem, 0, n);
+    }
+
+    /**
+     * @returns True if any element matches the predicate.
+     */
+    template <class Predicate> bool exists(const Predicate &p) const
+    {
+        return find(p) != nullptr;
+    }
+
+    /**
+     * @returns A pointer to the first element matching the predicate or nullptr.
+     */
+    // @{
+    template <class Predicate> T* find(const Predicate &p)
+    {
+        return const_cast<T*>(static_cast<const FixedDynArray<T, N, ErrorPolicy>*>(this)->find(p));
+    }
+
+    template <class Predicate> const T* find(const Predicate &p) const
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            if (p(buf[i])) return &buf[i];
+        }
+
+        return nullptr;
+    }
+    // @}
+
+    /**
+     * @returns A pointer to the last element matching the predicate or nullptr.
+     */
+    template <class Predicate> const T* findLast(const Predicate &p) const
+    {
+        size_t i = n;
+
+        while (i --> 0)
+        {
+            if (p(buf[i])) return &buf[i];
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @returns A new array of the elements matching the predicate.
+     */
+    template <class Predicate> FixedDynArray<T, N, ErrorPolicy> findAll(const Predicate &p) const
+    {
+        FixedDynArray<T, N, ErrorPolicy> matches;
+
+        static_cast<ErrorPolicy&>(matches) = *this;
+
+        for (size_t i = 0; i < n; i++)
+        {
+            if (p(buf[i])) matches.buf[matches.n++] = buf[i];
+        }
+
+        return matches;
+    }
+
+    /**
+     * Finds the first element matching the predicate in the given range.
+     *
+     * @returns The index of the match or -1. On out of range indices -1 with INDEX_OUT_OF_RANGE.
+     */
+    template <class Predicate> ssize_t findIndex(size_t start, size_t count, const Predicate &p) const
+    {
+        size_t end = start + count;
+
+        if (ErrorPolicy::checkBounds && ((start >= n) || (end > n)))
+        {
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
+            return -1;
+        }
+
+        for (size_t i = start; i < end; i++)
+        {
+            if (p(buf[i])) return i;
+        }
+
+        return -1;
+    }
+
+    template <class Predicate> ssize_t findIndex(size_t start, const Predicate &p) const
+    {
+        return findIndex(start, n - start, p);
+    }
+
+    template <class Predicate> ssize_t findIndex(const Predicate &p) const
+    {
+        if (n == 0) return -1;
+
+        return findIndex(0, n, p);
+    }
+
+    /**
+     * Finds the last element matching the predicate in the given range.
+     *
+     * @returns The index of the match or -1. On out of range indices -1 with INDEX_OUT_OF_RANGE.
+     */
+    template <class Predicate> ssize_t findLastIndex(size_t start, size_t count, const Predicate &p) const
+    {
+        size_t end = start + count;
+
+        if (ErrorPolicy::checkBounds && ((start >= n) || (end > n)))
+        {
+            this->reportError(DynArrayError::INDEX_OUT_OF_RANGE);
+            return -1;
+        }
+
+        size_t i = end;
+
+        while (i --> start)
+        {
+            if (p(buf[i])) return i;
+        }
+
+        return -1;
+    }
+
+    template <class Predicate> ssize_t findLastIndex(size_t start, const Predicate &p) const
+    {
+        return findLastIndex(start, n - start, p);
+    }
+
+    template <class Predicate> ssize_t findLastIndex(const Predicate &p) const
+    {
+        if (n == 0) return -1;
+
+        return findLastIndex(0, n, p);
+    }
+
+    /**
+     * Performs an action on each element of the array.
+     */
+    template <class Action> void forEach(const Action &a)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            a(buf[i]);
+        }
+    }
+
+    /**
+     * Copies the elements to the given C array starting at the given position.
+     */
+    void copyTo(T *array, size_t start = 0) const
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            array[start + i] = buf[i];
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,164 @@
+#ifdef UNIT_TEST
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include "learned_index.h"
+
+template <class T>
+struct Alloc
+{
+    T *allocate(size_t n) {return (T*)malloc(n * sizeof(T));}
+    T *reallocate(T* buf, size_t n) {return (T*)realloc((void*)buf, n * sizeof(T)); }
+    void deallocate(T *buf) {free(buf);}
+};
+
+/** Allocator that always fails. */
+template <class T>
+struct FailingAlloc
+{
+    T *allocate(size_t) {return nullptr;}
+    T *reallocate(T*, size_t) {return nullptr;}
+    void deallocate(T *) {}
+};
+
+DynArrayError theError;
+
+void errorCallback(DynArrayError error, void *context)
+{
+    theError = error;
+    (void)context;
+}
+
+template <class T> using Index = LearnedIndex<T, Alloc<LearnedIndexSegment<T>>>;
+
+/**
+ * Looks up each element, the values between them and the values outside and compares the results with
+ * DynArray::lowerBound, with several error bounds.
+ */
+template <class T> void check(DynArray<T, Alloc<T>> &sorted)
+{
+    static const size_t epsilons[] = {0, 1, 4, 32};
+
+    for (size_t epsilon : epsilons)
+    {
+        Index<T> index(epsilon);
+
+        assert(!index.build(sorted));
+        assert(index.getCount() == sorted.getCount());
+
+        for (size_t i = 0; i < sorted.getCount(); i++)
+        {
+            T elem = sorted[i];
+            T below = (T)(elem - 1);
+            T above = (T)(elem + 1);
+
+            assert(index.lowerBound(elem) == sorted.lowerBound(elem));
+            assert(index.contains(elem));
+            if (below < elem) assert(index.lowerBound(below) == sorted.lowerBound(below));
+            if (above > elem) assert(index.lowerBound(above) == sorted.lowerBound(above));
+            if (above > elem) assert(index.contains(above) == sorted.binarySearch(above));
+        }
+    }
+}
+
+int main()
+{
+    {
+        // Empty.
+        DynArray<int, Alloc<int>> sorted;
+        Index<int> index;
+
+        assert(!index.build(sorted));
+        assert(index.lowerBound(5) == 0);
+        assert(!index.contains(5));
+        assert(index.getSegmentCount() == 0);
+    }
+
+    {
+        // A line is a single segment.
+        DynArray<int64_t, Alloc<int64_t>> sorted;
+        Index<int64_t> index(0);
+
+        for (int64_t i = 0; i < 10000; i++) assert(!sorted.add(1000000 + i * 7));
+        assert(!index.build(sorted));
+        assert(index.getSegmentCount() == 1);
+        assert(index.lowerBound(1000000 + 7 * 5000) == 5000);
+        assert(index.lowerBound(1000000 + 7 * 5000 + 1) == 5001);
+        assert(index.lowerBound(0) == 0);
+        assert(index.lowerBound(INT64_MAX) == 10000);
+        check(sorted);
+    }
+
+    {
+        // Timestamps with jitter, a few segments.
+        DynArray<uint64_t, Alloc<uint64_t>> sorted;
+        uint64_t t = 1700000000000ull;
+
+        srand(1);
+        for (int i = 0; i < 20000; i++)
+        {
+            t += 900 + rand() % 200;
+            assert(!sorted.add(t));
+        }
+
+        Index<uint64_t> index(32);
+        assert(!index.build(sorted));
+        assert(index.getSegmentCount() < 200);
+        check(sorted);
+    }
+
+    {
+        // Curved, with long runs of duplicates which break the window for the values after them.
+        DynArray<int32_t, Alloc<int32_t>> sorted;
+
+        for (int32_t i = 0; i < 3000; i++) assert(!sorted.add(i * i / 100));
+        for (int32_t i = 0; i < 500; i++) assert(!sorted.add(100000));
+        for (int32_t i = 0; i < 500; i++) assert(!sorted.add(100000 + i * 1000));
+
+        check(sorted);
+    }
+
+    {
+        // Large 64 bit keys which lose precision as doubles.
+        DynArray<uint64_t, Alloc<uint64_t>> sorted;
+
+        for (uint64_t i = 0; i < 3000; i++) assert(!sorted.add(0xfffffffffff00000ull + i * (i % 3)));
+        for (size_t i = 1; i < sorted.getCount(); i++) if (sorted[i] < sorted[i - 1]) sorted[i] = sorted[i - 1];
+
+        check(sorted);
+    }
+
+    {
+        // Floating point and negative keys.
+        DynArray<double, Alloc<double>> doubles;
+        DynArray<int8_t, Alloc<int8_t>> bytes;
+
+        for (int i = 0; i < 2000; i++) assert(!doubles.add(-1e6 + i * i * 0.5));
+        for (int i = -128; i < 128; i += 3) assert(!bytes.add((int8_t)i));
+
+        check(doubles);
+        check(bytes);
+    }
+
+    {
+        // Allocation failure.
+        DynArray<int, Alloc<int>> sorted;
+        LearnedIndex<int, FailingAlloc<LearnedIndexSegment<int>>> index;
+
+        index.setErrorCb(errorCallback, nullptr);
+        assert(!sorted.add(1));
+        theError = DynArrayError::OK;
+        assert(index.build(sorted));
+        assert(theError == DynArrayError::ALLOCATION_FAILURE);
+        assert(index.getCount() == 0);
+        assert(!index.contains(1));
+    }
+
+    printf("Passed: %s %s\n", __DATE__, __TIME__);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,287 @@
+#ifndef LEARNED_INDEX_H
+#define LEARNED_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <limits>
+#include <type_traits>
+
+#include "dynamic_array.h"
+
+/**
+ * A line of the learned index: the elements from start up to the next segment are predicted to be at
+ * start + slope * (elem - key).
+ */
+template <class T>
+struct LearnedIndexSegment
+{
+    T key; ///< The first key of the segment.
+    double slope; ///< Positions per unit of key.
+    size_t start; ///< The index of the first occurrence of key.
+};
+
+/**
+ * Learned (piecewise linear) index over a sorted array of numbers.
+ *
+ * Approximates the position of each key with a few line segments, each predicting the positions of its keys within
+ * epsilon. A lookup finds the segment by binary search over the segments, computes the position and searches the
+ * 2 * epsilon + 1 elements around it in the array. For smooth data like timestamps or sequential IDs there are
+ * orders of magnitude fewer segments than elements, so the index takes a fraction of the memory of the array and
+ * a lookup touches the array in one place only.
+ *
+ * The segments are built in a single pass with the shrinking cone algorithm: a segment keeps the range of slopes
+ * that still predict all its keys within epsilon and ends when the next key falls outside.
+ *
+ * The prediction is verified, if the element isn't in the window (a key missing from the array after a long run of
+ * duplicates, or precision lost converting large 64 bit keys to double) the search gallops outwards from it, so
+ * the results are always exact.
+ *
+ * Example:
+ *
+ *   LearnedIndex<uint64_t, Alloc<LearnedIndexSegment<uint64_t>>> index(32);
+ *
+ *   if (index.build(timestamps)) return -1;
+ *   ssize_t i = index.lowerBound(t); // Same as timestamps.lowerBound(t).
+ *
+ * @tparam T The type of elements, an arithmetic type. Floats mustn't be NaN.
+ * @tparam Alloc The allocator used to allocate the segments, allocates LearnedIndexSegment<T>.
+ * @tparam ErrorPolicy Decides how errors are handled. See DynArrayRuntimeErrors.
+ *
+ * @remarks
+ *    Unlike the other indexes the elements aren't copied, the index refers to the buffer of the array it's built
+ *    from. The array must not be modified or destroyed while the index is used.
+ */
+template <class T, class Alloc, class ErrorPolicy = DynArrayRuntimeErrors>
+class LearnedIndex : public ErrorPolicy
+{
+    static_assert(std::is_arithmetic<T>::value, "Need numbers.");
+
+    typedef LearnedIndexSegment<T> Segment;
+
+    DynArray<Segment, Alloc, DynArrayDoublingGrowth, DynArrayUnchecked> segments; ///< Sorted by key.
+    const T *data = nullptr; ///< The buffer of the array the index is built from.
+    size_t n = 0; ///< The number of elements in the array.
+    size_t epsilon; ///< The maximal prediction error for the keys in the array.
+
+    /**
+     * @returns The index of the first element not less than elem in [lo, hi), or hi if there is none.
+     */
+    size_t searchWindow(size_t lo, size_t hi, const T &elem) const
+    {
+        size_t length = hi - lo;
+        const T *base = data + lo;
+
+        if (length == 0) return lo;
+
+        while (length > 1)
+        {
+            size_t half = length / 2;
+
+            base = (base[half] < elem) ? base + half : base;
+            length -= half;
+        }
+
+        return (base - data) + (*base < elem);
+    }
+
+public:
+
+    /**
+     * Initializes an empty index.
+     *
+     * @param[in] epsilon The maximal prediction error in elements. Smaller values need more segments but search
+     *      fewer elements per lookup.
+     * @param[in] alloc An instance of the allocator used to allocate the segments.
+     */
+    LearnedIndex(size_t epsilon = 32, const Alloc &alloc = Alloc()) : segments(alloc), epsilon(epsilon) {}
+
+    /**
+     * Builds the index from a sorted array in O(n), replacing the previous contents.
+     *
+     * @param[in] sorted The array, sorted in ascending order. Must outlive the index and must not be modified.
+     * @returns Zero on success, non-zero on failure.
+     *
+     * @remarks
+     *    If we run out of memory the ALLOCATION_FAILURE error is set and the index is left empty.
+     */
+    template <class A, class G, class E> int build(const DynArray<T, A, G, E> &sorted)
+    {
+        const T *src = sorted.begin();
+        size_t count = sorted.end() - src;
+
+        segments.clear();
+        data = nullptr;
+        n = 0;
+
+        if (count == 0) return 0;
+
+        Segment current = {src[0], 0, 0};
+        double low = 0; // The range of the slopes that predict every key of the segment so far within epsilon.
+        double high = std::numeric_limits<double>::infinity();
+
+        for (size_t i = 1; i <= count; i++)
+        {
+            if ((i < count) && (src[i] == src[i - 1])) continue; // Only the first of equal keys is predicted.
+
+            double dx = (i < count) ? (double)src[i] - (double)current.key : 0;
+            double dy = (double)(i - current.start);
+
+            if ((dx > 0) && (dy >= low * dx) && (dy <= high * dx))
+            {
+                double newLow = (dy - epsilon) / dx;
+                double newHigh = (dy + epsilon) / dx;
+
+                if (newLow > low) low = newLow;
+                if (newHigh < high) high = newHigh;
+
+                continue;
+            }
+
+            // The key doesn't fit or the array ended, close the segment.
+            current.slope = (high == std::numeric_limits<double>::infinity()) ? low : (low + high) / 2;
+
+            if (segments.add(current))
+            {
+                segments.clear();
+                this->reportError(DynArrayError::ALLOCATION_FAILURE);
+                return -1;
+            }
+
+            if (i < count)
+            {
+                current.key = src[i];
+                current.start = i;
+                low = 0;
+                high = std::numeric_limits<double>::infinity();
+            }
+        }
+
+        segments.setCapacity(segments.getCount()); // Best effort, the index works without it.
+
+        data = src;
+        n = count;
+
+        return 0;
+    }
+
+    /**
+     * Finds the first element that is not less than the given one.
+     *
+     * @param[in] elem The element to search for.
+     * @returns The index of the element in the array the index was built from, getCount() if there is none.
+     *      Same as DynArray::lowerBound.
+     */
+    ssize_t lowerBound(const T &elem) const
+    {
+        const Segment *first = segments.begin();
+        size_t segmentCount = segments.end() - first;
+
+        if ((n == 0) || (elem < first->key)) return 0;
+
+        // The last segment starting at or before elem.
+        const Segment *s = first;
+        size_t length = segmentCount;
+
+        while (length > 1)
+        {
+            size_t half = length / 2;
+
+            s = (elem < s[half].key) ? s : s + half;
+            length -= half;
+        }
+
+        // The first of the keys is at start and every element of the next segment is greater, so the result is
+        // in [start, end].
+        size_t start = s->start;
+        size_t end = (s + 1 < first + segmentCount) ? s[1].start : n;
+        double predicted = start + s->slope * ((double)elem - (double)s->key);
+        size_t pos = predicted < (double)end ? (size_t)predicted : end;
+
+        size_t lo = pos - start > epsilon ? pos - epsilon : start;
+        size_t hi = end - pos > epsilon ? pos + epsilon + 1 : end;
+
+        // Fetch the window at once, so the steps of the search don't wait for the lines one after the other.
+        for (const char *line = (const char*)(data + lo); line < (const char*)(data + hi); line += 64)
+        {
+            __builtin_prefetch(line);
+        }
+
+        if ((lo > start) && !(data[lo - 1] < elem))
+        {
+            // The result is before the window, gallop down.
+            size_t step = 1;
+
+            hi = lo - 1;
+            while (true)
+            {
+                if (hi - start < step)
+                {
+                    lo = start;
+                    break;
+                }
+
+                if (data[hi - step] < elem)
+                {
+                    lo = hi - step + 1;
+                    break;
+                }
+
+                hi -= step;
+                step *= 2;
+            }
+        }
+        else if ((hi < end) && (data[hi] < elem))
+        {
+            // The result is after the window, gallop up.
+            size_t step = 1;
+
+            lo = hi + 1;
+            while (true)
+            {
+                if (end - lo < step)
+                {
+                    hi = end;
+                    break;
+                }
+
+                if (!(data[lo + step - 1] < elem))
+                {
+                    hi = lo + step - 1;
+                    break;
+                }
+
+                lo += step;
+                step *= 2;
+            }
+        }
+
+        return searchWindow(lo, hi, elem);
+    }
+
+    /**
+     * Checks if the element is in the array.
+     *
+     * @param[in] elem The element to search for.
+     * @returns True if the element is found.
+     */
+    bool contains(const T &elem) const
+    {
+        size_t index = lowerBound(elem);
+
+        return (index < n) && (data[index] == elem);
+    }
+
+    /**
+     * @returns The number of elements in the array the index was built from.
+     */
+    size_t getCount() const {return n;}
+
+    /**
+     * @returns The number of line segments, the memory used is about this times sizeof(LearnedIndexSegment<T>).
+     */
+    size_t getSegmentCount() const {return segments.end() - segments.begin();}
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifdef BENCHMARK
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "benchmark.h"
+#include "learned_index.h"
+
+template <class T>
+struct Alloc
+{
+    T *allocate(size_t n) {return (T*)malloc(n * sizeof(T));}
+    T *reallocate(T* buf, size_t n) {return (T*)realloc(buf, n * sizeof(T));}
+    void deallocate(T *buf) {free(buf);}
+};
+
+/**
+ * Builds learned indexes with several error bounds over millisecond timestamps with jitter, then looks up random
+ * timestamps with them and with binarySearch and lowerBound on the array. The sizes are picked to fit the levels
+ * of the cache hierarchy.
+ */
+static void benchTimestamps(const char *level, size_t count)
+{
+    const size_t lookups = 4 * 1024 * 1024;
+    DynArray<uint64_t, Alloc<uint64_t>> sorted;
+    DynArray<uint64_t, Alloc<uint64_t>> keys;
+
+    if (!sorted.appendUninitialized(count) || !keys.appendUninitialized(lookups)) return;
+
+    uint64_t state = 88172645463325252ull;
+    uint64_t t = 1700000000000ull;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+        t += 500 + state % 1000;
+        sorted[i] = t;
+    }
+
+    uint64_t range = t - sorted[0];
+
+    for (size_t i = 0; i < lookups; i++)
+    {
+        state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+        keys[i] = sorted[0] + state % range;
+    }
+
+    char name[64];
+    size_t sum = 0;
+
+    snprintf(name, sizeof(name), "binarySearch %s", level);
+    double start = benchNow();
+    for (size_t i = 0; i < lookups; i++) sum += sorted.binarySearch(keys[i]);
+    benchReport(name, benchNow() - start, lookups);
+
+    snprintf(name, sizeof(name), "lowerBound %s", level);
+    start = benchNow();
+    for (size_t i = 0; i < lookups; i++) sum += sorted.lowerBound(keys[i]);
+    benchReport(name, benchNow() - start, lookups);
+
+    static const size_t epsilons[] = {16, 64, 256};
+
+    for (size_t epsilon : epsilons)
+    {
+        LearnedIndex<uint64_t, Alloc<LearnedIndexSegment<uint64_t>>> index(epsilon);
+
+        snprintf(name, sizeof(name), "build learned %s, eps %zu", level, epsilon);
+        start = benchNow();
+        if (index.build(sorted)) return;
+        benchReport(name, benchNow() - start, count);
+        printf("%-48s %10zu segments, %.3f MB\n", "", index.getSegmentCount(),
+            index.getSegmentCount() * sizeof(LearnedIndexSegment<uint64_t>) / 1048576.0);
+
+        snprintf(name, sizeof(name), "lowerBound learned %s, eps %zu", level, epsilon);
+        start = benchNow();
+        for (size_t i = 0; i < lookups; i++) sum -= index.lowerBound(keys[i]);
+        benchReport(name, benchNow() - start, lookups);
+    }
+
+    benchKeep(sum);
+}
+
+int main()
+{
+    benchTimestamps("1 MB (L2)", 128 * 1024);
+    benchTimestamps("64 MB (L3)", 8 * 1024 * 1024);
+    benchTimestamps("400 MB (DRAM)", 50 * 1000 * 1000);
+
+    return 0;
+}
+
+#endif
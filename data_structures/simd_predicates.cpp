@@ -0,0 +1,176 @@
+#ifdef UNIT_TEST
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+#include <limits>
+
+#include "simd_predicates.h"
+
+template <class T, class P> ssize_t referenceFindFirst(const T *buf, size_t n, const P &p)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (p(buf[i])) return i;
+    }
+
+    return -1;
+}
+
+template <class T, class P> ssize_t referenceFindLast(const T *buf, size_t n, const P &p)
+{
+    for (size_t i = n; i --> 0;)
+    {
+        if (p(buf[i])) return i;
+    }
+
+    return -1;
+}
+
+/**
+ * Runs the predicate over every length up to 300, from an unaligned start too, and compares the vector results
+ * with the results of calling the functor.
+ */
+template <class T, class P> void testPredicate(const T *values, size_t valueCount, const P &p)
+{
+    static T storage[301];
+    static T out[301];
+    static T expected[301];
+
+    for (size_t n = 0; n <= 300; n++)
+    {
+        T *buf = storage + (n & 1); // Unaligned every second time.
+
+        for (size_t i = 0; i < n; i++) buf[i] = values[(i * 7 + n) % valueCount];
+
+        assert(simdFindFirst(buf, n, p) == referenceFindFirst(buf, n, p));
+        assert(simdFindLast(buf, n, p) == referenceFindLast(buf, n, p));
+
+        for (int keep = 0; keep < 2; keep++)
+        {
+            size_t expectedCount = 0;
+
+            for (size_t i = 0; i < n; i++)
+            {
+                if (p(buf[i]) == (bool)keep) expected[expectedCount++] = buf[i];
+            }
+
+            assert(simdCompress(buf, n, p, keep, out) == expectedCount);
+            assert(memcmp(out, expected, expectedCount * sizeof(T)) == 0);
+        }
+
+        // In place.
+        size_t kept = simdCompress(buf, n, p, false, buf);
+
+        for (size_t i = 0; i < kept; i++) assert(!p(buf[i]));
+    }
+}
+
+/**
+ * Tests each predicate kind with a spread of values around the bounds, including the extremes of the type.
+ */
+template <class T> void testType(T low, T high)
+{
+    const T minValue = std::numeric_limits<T>::is_integer ? std::numeric_limits<T>::min() : -std::numeric_limits<T>::max();
+    const T maxValue = std::numeric_limits<T>::max();
+    T values[] = {minValue, maxValue, low, high, (T)(low - 1), (T)(low + 1), (T)(high - 1), (T)(high + 1), 0, 1};
+    const size_t valueCount = sizeof(values) / sizeof(values[0]);
+
+    testPredicate(values, valueCount, simdEq(low));
+    testPredicate(values, valueCount, simdLt(low));
+    testPredicate(values, valueCount, simdGt(high));
+    testPredicate(values, valueCount, simdLt(minValue));
+    testPredicate(values, valueCount, simdGt(maxValue));
+    testPredicate(values, valueCount, simdBetween(low, high));
+    testPredicate(values, valueCount, simdBetween(high, low));
+    testPredicate(values, valueCount, simdBetween(minValue, maxValue));
+    testPredicate(values, valueCount, simdInSet(low));
+    testPredicate(values, valueCount, simdInSet(minValue, high, (T)1));
+    testPredicate(values, valueCount, simdAnd(simdGt(low), simdLt(high)));
+    testPredicate(values, valueCount, simdOr(simdEq(minValue), simdGt(high)));
+    testPredicate(values, valueCount, simdNot(simdBetween(low, high)));
+    testPredicate(values, valueCount, simdNot(simdOr(simdLt(low), simdInSet((T)0, (T)1))));
+}
+
+/**
+ * NaN compares false with everything, so only the negations match it.
+ */
+template <class T> void testNan()
+{
+    T values[] = {(T)NAN, (T)-0.0, (T)0.0, (T)1, (T)-1, (T)INFINITY, (T)-INFINITY};
+    const size_t valueCount = sizeof(values) / sizeof(values[0]);
+
+    testPredicate(values, valueCount, simdLt((T)0));
+    testPredicate(values, valueCount, simdGt((T)-0.0));
+    testPredicate(values, valueCount, simdBetween((T)-0.0, (T)1));
+    testPredicate(values, valueCount, simdInSet((T)0, (T)INFINITY));
+    testPredicate(values, valueCount, simdNot(simdLt((T)1)));
+    testPredicate(values, valueCount, simdNot(simdBetween((T)-INFINITY, (T)INFINITY)));
+
+    T nanOnly[10];
+    for (size_t i = 0; i < 10; i++) nanOnly[i] = (T)NAN;
+
+    assert(simdFindFirst(nanOnly, 10, simdBetween((T)-INFINITY, (T)INFINITY)) == -1);
+    assert(simdFindFirst(nanOnly, 10, simdNot(simdBetween((T)-INFINITY, (T)INFINITY))) == 0);
+}
+
+struct Point
+{
+    int x, y;
+};
+
+int main()
+{
+    static_assert(SimdPredicateFor<SimdLt<int>, int>::value, "");
+    static_assert(SimdPredicateFor<SimdNot<SimdAnd<SimdLt<float>, SimdGt<float> > >, float>::value, "");
+    static_assert(!SimdPredicateFor<SimdLt<int>, unsigned>::value, "");
+    static_assert(!SimdPredicateFor<SimdLt<long double>, long double>::value, "");
+    static_assert(!SimdPredicateFor<bool (*)(const int&), int>::value, "");
+
+    SimdLevel detected = simdDetectLevel();
+    printf("Detected level: %d\n", (int)detected);
+
+    for (int level = (int)SimdLevel::SCALAR; level <= (int)detected; level++)
+    {
+        assert(simdSetLevel((SimdLevel)level) == (SimdLevel)level);
+
+        testType<int8_t>(-100, 50);
+        testType<uint8_t>(20, 200);
+        testType<int16_t>(-1000, 30000);
+        testType<uint16_t>(100, 60000);
+        testType<int32_t>(-5, 5);
+        testType<uint32_t>(7, 4000000000u);
+        testType<int64_t>(-(1ll << 40), 1ll << 40);
+        testType<uint64_t>(3, 1ull << 63);
+        testType<float>(-0.5f, 2.5f);
+        testType<double>(-1e300, 1e-300);
+        testNan<float>();
+        testNan<double>();
+    }
+
+    assert(simdSetLevel(SimdLevel::AVX512) == detected);
+
+    // The 64 bit compares must use both halves.
+    int64_t halves[8] = {0x100000000ll, 0xffffffffll, -0x100000000ll, -1, 0, 0, 0, 0x100000001ll};
+    assert(simdFindFirst(halves, 8, simdGt((int64_t)0xffffffffll)) == 0);
+    assert(simdFindLast(halves, 8, simdGt((int64_t)0xffffffffll)) == 7);
+    assert(simdFindFirst(halves, 8, simdLt((int64_t)-1)) == 2);
+
+    // Functors that aren't predicates from here are called on each element.
+    Point points[3] = {{1, 2}, {3, 4}, {1, 2}};
+    Point kept[3];
+    auto isFirst = [](const Point &p) {return p.x == 1;};
+    assert(simdFindFirst(points, 3, isFirst) == 0);
+    assert(simdFindLast(points, 3, isFirst) == 2);
+    assert(simdCompress(points, 3, isFirst, false, kept) == 1);
+    assert(kept[0].x == 3);
+
+    printf("Passed: %s %s\n", __DATE__, __TIME__);
+
+    return 0;
+}
+
+#endif
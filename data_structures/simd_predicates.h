@@ -0,0 +1,915 @@
+#ifndef SIMD_PREDICATES_H
+#define SIMD_PREDICATES_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include <type_traits>
+
+#include "simd_search.h"
+
+/**
+ * Composable predicates for numeric arrays.
+ *
+ * Each predicate is a plain functor, so it works anywhere a bool predicate(const T &elem) is expected. The
+ * DynArray search functions (findIndex, findLastIndex, exists, findAll, removeIf, retainIf) also recognize them and
+ * evaluate a whole vector of elements at once into a bitmask, findAll and removeIf then compress the matching
+ * elements with vector stores.
+ *
+ *   ssize_t i = array.findIndex(simdAnd(simdBetween(10, 20), simdNot(simdInSet(13, 17))));
+ *
+ * The vector kernels are compiled for AVX2 and AVX-512 and picked at runtime like the ones in simd_search.h. On
+ * other CPUs, and for element types that aren't integers or floating point numbers, the predicates are called for
+ * each element. A predicate is only vectorized if its element type is exactly the element type of the array.
+ *
+ * Comparisons work the same as the C++ operators on the element type, including NaN never being equal, less or
+ * greater.
+ */
+
+/** The base of all vectorizable predicates, used to recognize them. */
+struct SimdPredicate {};
+
+/**
+ * Tells whether P is a vectorizable predicate for elements of type T.
+ */
+// @{
+template <class P, class T, bool IsPredicate = std::is_base_of<SimdPredicate, P>::value>
+struct SimdPredicateFor : std::false_type {};
+
+template <class P, class T> struct SimdPredicateFor<P, T, true>
+    : std::integral_constant<bool, std::is_same<typename P::ElemType, T>::value && SimdSearchable<T>::value> {};
+// @}
+
+#ifdef SIMD_SEARCH_X86
+
+/**
+ * AVX2 comparisons. A comparison returns a vector with all bits of the matching lanes set, bits converts it to an
+ * element mask with one bit per element.
+ */
+// @{
+template <size_t Size> struct SimdAvx2Int;
+
+template <> struct SimdAvx2Int<1>
+{
+    SIMD_TARGET_AVX2 static __m256i splat(uint64_t v) {return _mm256_set1_epi8((char)v);}
+    SIMD_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) {return _mm256_cmpeq_epi8(a, b);}
+    SIMD_TARGET_AVX2 static __m256i gt(__m256i a, __m256i b) {return _mm256_cmpgt_epi8(a, b);}
+    SIMD_TARGET_AVX2 static uint32_t bits(__m256i m) {return _mm256_movemask_epi8(m);}
+};
+
+template <> struct SimdAvx2Int<2>
+{
+    SIMD_TARGET_AVX2 static __m256i splat(uint64_t v) {return _mm256_set1_epi16((short)v);}
+    SIMD_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) {return _mm256_cmpeq_epi16(a, b);}
+    SIMD_TARGET_AVX2 static __m256i gt(__m256i a, __m256i b) {return _mm256_cmpgt_epi16(a, b);}
+
+    SIMD_TARGET_AVX2 static uint32_t bits(__m256i m)
+    {
+        return _mm_movemask_epi8(_mm_packs_epi16(_mm256_castsi256_si128(m), _mm256_extracti128_si256(m, 1)));
+    }
+};
+
+template <> struct SimdAvx2Int<4>
+{
+    SIMD_TARGET_AVX2 static __m256i splat(uint64_t v) {return _mm256_set1_epi32((int)v);}
+    SIMD_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) {return _mm256_cmpeq_epi32(a, b);}
+    SIMD_TARGET_AVX2 static __m256i gt(__m256i a, __m256i b) {return _mm256_cmpgt_epi32(a, b);}
+    SIMD_TARGET_AVX2 static uint32_t bits(__m256i m) {return _mm256_movemask_ps(_mm256_castsi256_ps(m));}
+};
+
+template <> struct SimdAvx2Int<8>
+{
+    SIMD_TARGET_AVX2 static __m256i splat(uint64_t v) {return _mm256_set1_epi64x((long long)v);}
+    SIMD_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) {return _mm256_cmpeq_epi64(a, b);}
+    SIMD_TARGET_AVX2 static __m256i gt(__m256i a, __m256i b) {return _mm256_cmpgt_epi64(a, b);}
+    SIMD_TARGET_AVX2 static uint32_t bits(__m256i m) {return _mm256_movemask_pd(_mm256_castsi256_pd(m));}
+};
+
+template <class T, bool Float = std::is_floating_point<T>::value>
+struct SimdAvx2Ops
+{
+    typedef SimdAvx2Int<sizeof(T)> Int;
+
+    static const size_t W = 32 / sizeof(T);
+
+    /** Unsigned elements are compared as signed ones after flipping their sign bits. */
+    SIMD_TARGET_AVX2 static __m256i bias(__m256i x)
+    {
+        return std::is_signed<T>::value ? x : _mm256_xor_si256(x, Int::splat(1ull << (sizeof(T) * 8 - 1)));
+    }
+
+    SIMD_TARGET_AVX2 static __m256i load(const T *p) {return bias(_mm256_loadu_si256((const __m256i*)p));}
+    SIMD_TARGET_AVX2 static __m256i splat(T v) {return bias(Int::splat((uint64_t)v));}
+    SIMD_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b) {return Int::eq(a, b);}
+    SIMD_TARGET_AVX2 static __m256i lt(__m256i a, __m256i b) {return Int::gt(b, a);}
+
+    SIMD_TARGET_AVX2 static __m256i le(__m256i a, __m256i b)
+    {
+        return _mm256_andnot_si256(Int::gt(a, b), _mm256_set1_epi32(-1));
+    }
+
+    SIMD_TARGET_AVX2 static uint32_t bits(__m256i m) {return Int::bits(m);}
+};
+
+template <> struct SimdAvx2Ops<float, true>
+{
+    static const size_t W = 8;
+
+    SIMD_TARGET_AVX2 static __m256i load(const float *p) {return _mm256_castps_si256(_mm256_loadu_ps(p));}
+    SIMD_TARGET_AVX2 static __m256i splat(float v) {return _mm256_castps_si256(_mm256_set1_ps(v));}
+
+    SIMD_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b)
+    {
+        return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+    }
+
+    SIMD_TARGET_AVX2 static __m256i lt(__m256i a, __m256i b)
+    {
+        return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_LT_OQ));
+    }
+
+    SIMD_TARGET_AVX2 static __m256i le(__m256i a, __m256i b)
+    {
+        return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_LE_OQ));
+    }
+
+    SIMD_TARGET_AVX2 static uint32_t bits(__m256i m) {return _mm256_movemask_ps(_mm256_castsi256_ps(m));}
+};
+
+template <> struct SimdAvx2Ops<double, true>
+{
+    static const size_t W = 4;
+
+    SIMD_TARGET_AVX2 static __m256i load(const double *p) {return _mm256_castpd_si256(_mm256_loadu_pd(p));}
+    SIMD_TARGET_AVX2 static __m256i splat(double v) {return _mm256_castpd_si256(_mm256_set1_pd(v));}
+
+    SIMD_TARGET_AVX2 static __m256i eq(__m256i a, __m256i b)
+    {
+        return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+    }
+
+    SIMD_TARGET_AVX2 static __m256i lt(__m256i a, __m256i b)
+    {
+        return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_LT_OQ));
+    }
+
+    SIMD_TARGET_AVX2 static __m256i le(__m256i a, __m256i b)
+    {
+        return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_LE_OQ));
+    }
+
+    SIMD_TARGET_AVX2 static uint32_t bits(__m256i m) {return _mm256_movemask_pd(_mm256_castsi256_pd(m));}
+};
+// @}
+
+/**
+ * AVX-512 comparisons. A comparison returns an element mask with one bit per element.
+ */
+// @{
+template <class T, size_t Size = sizeof(T), bool Signed = std::is_signed<T>::value,
+    bool Float = std::is_floating_point<T>::value>
+struct SimdAvx512Ops;
+
+template <class T> struct SimdAvx512Ops<T, 1, true, false>
+{
+    static const size_t W = 64;
+
+    SIMD_TARGET_AVX512 static __m512i splat(T v) {return _mm512_set1_epi8((char)v);}
+    SIMD_TARGET_AVX512 static uint64_t eq(__m512i a, __m512i b) {return _mm512_cmp_epi8_mask(a, b, _MM_CMPINT_EQ);}
+    SIMD_TARGET_AVX512 static uint64_t lt(__m512i a, __m512i b) {return _mm512_cmp_epi8_mask(a, b, _MM_CMPINT_LT);}
+    SIMD_TARGET_AVX512 static uint64_t le(__m512i a, __m512i b) {return _mm512_cmp_epi8_mask(a, b, _MM_CMPINT_LE);}
+};
+
+template <class T> struct SimdAvx512Ops<T, 1, false, false>
+{
+    static const size_t W = 64;
+
+    SIMD_TARGET_AVX512 static __m512i splat(T v) {return _mm512_set1_epi8((char)v);}
+    SIMD_TARGET_AVX512 static uint64_t eq(__m512i a, __m512i b) {return _mm512_cmp_epu8_mask(a, b, _MM_CMPINT_EQ);}
+    SIMD_TARGET_AVX512 static uint64_t lt(__m512i a, __m512i b) {return _mm512_cmp_epu8_mask(a, b, _MM_CMPINT_LT);}
+    SIMD_TARGET_AVX512 static uint64_t le(__m512i a, __m512i b) {return _mm512_cmp_epu8_mask(a, b, _MM_CMPINT_LE);}
+};
+
+template <class T> struct SimdAvx512Ops<T, 2, true, false>
+{
+    static const size_t W = 32;
+
+    SIMD_TARGET_AVX512 static __m512i splat(T v) {return _mm512_set1_epi16((short)v);}
+    SIMD_TARGET_AVX512 static uint64_t eq(__m512i a, __m512i b) {return _mm512_cmp_epi16_mask(a, b, _MM_CMPINT_EQ);}
+    SIMD_TARGET_AVX512 static uint64_t lt(__m512i a, __m512i b) {return _mm512_cmp_epi16_mask(a, b, _MM_CMPINT_LT);}
+    SIMD_TARGET_AVX512 static uint64_t le(__m512i a, __m512i b) {return _mm512_cmp_epi16_mask(a, b, _MM_CMPINT_LE);}
+};
+
+template <class T> struct SimdAvx512Ops<T, 2, false, false>
+{
+    static const size_t W = 32;
+
+    SIMD_TARGET_AVX512 static __m512i splat(T v) {return _mm512_set1_epi16((short)v);}
+    SIMD_TARGET_AVX512 static uint64_t eq(__m512i a, __m512i b) {return _mm512_cmp_epu16_mask(a, b, _MM_CMPINT_EQ);}
+    SIMD_TARGET_AVX512 static uint64_t lt(__m512i a, __m512i b) {return _mm512_cmp_epu16_mask(a, b, _MM_CMPINT_LT);}
+    SIMD_TARGET_AVX512 static uint64_t le(__m512i a, __m512i b) {return _mm512_cmp_epu16_mask(a, b, _MM_CMPINT_LE);}
+};
+
+template <class T> struct SimdAvx512Ops<T, 4, true, false>
+{
+    static const size_t W = 16;
+
+    SIMD_TARGET_AVX512 static __m512i splat(T v) {return _mm512_set1_epi32((int)v);}
+    SIMD_TARGET_AVX512 static uint64_t eq(__m512i a, __m512i b) {return _mm512_cmp_epi32_mask(a, b, _MM_CMPINT_EQ);}
+    SIMD_TARGET_AVX512 static uint64_t lt(__m512i a, __m512i b) {return _mm512_cmp_epi32_mask(a, b, _MM_CMPINT_LT);}
+    SIMD_TARGET_AVX512 static uint64_t le(__m512i a, __m512i b) {return _mm512_cmp_epi32_mask(a, b, _MM_CMPINT_LE);}
+};
+
+template <class T> struct SimdAvx512Ops<T, 4, false, false>
+{
+    static const size_t W = 16;
+
+    SIMD_TARGET_AVX512 static __m512i splat(T v) {return _mm512_set1_epi32((int)v);}
+    SIMD_TARGET_AVX512 static uint64_t eq(__m512i a, __m512i b) {return _mm512_cmp_epu32_mask(a, b, _MM_CMPINT_EQ);}
+    SIMD_TARGET_AVX512 static uint64_t lt(__m512i a, __m512i b) {return _mm512_cmp_epu32_mask(a, b, _MM_CMPINT_LT);}
+    SIMD_TARGET_AVX512 static uint64_t le(__m512i a, __m512i b) {return _mm512_cmp_epu32_mask(a, b, _MM_CMPINT_LE);}
+};
+
+template <class T> struct SimdAvx512Ops<T, 8, true, false>
+{
+    static const size_t W = 8;
+
+    SIMD_TARGET_AVX512 static __m512i splat(T v) {return _mm512_set1_epi64((long long)v);}
+    SIMD_TARGET_AVX512 static uint64_t eq(__m512i a, __m512i b) {return _mm512_cmp_epi64_mask(a, b, _MM_CMPINT_EQ);}
+    SIMD_TARGET_AVX512 static uint64_t lt(__m512i a, __m512i b) {return _mm512_cmp_epi64_mask(a, b, _MM_CMPINT_LT);}
+    SIMD_TARGET_AVX512 static uint64_t le(__m512i a, __m512i b) {return _mm512_cmp_epi64_mask(a, b, _MM_CMPINT_LE);}
+};
+
+template <class T> struct SimdAvx512Ops<T, 8, false, false>
+{
+    static const size_t W = 8;
+
+    SIMD_TARGET_AVX512 static __m512i splat(T v) {return _mm512_set1_epi64((long long)v);}
+    SIMD_TARGET_AVX512 static uint64_t eq(__m512i a, __m512i b) {return _mm512_cmp_epu64_mask(a, b, _MM_CMPINT_EQ);}
+    SIMD_TARGET_AVX512 static uint64_t lt(__m512i a, __m512i b) {return _mm512_cmp_epu64_mask(a, b, _MM_CMPINT_LT);}
+    SIMD_TARGET_AVX512 static uint64_t le(__m512i a, __m512i b) {return _mm512_cmp_epu64_mask(a, b, _MM_CMPINT_LE);}
+};
+
+template <> struct SimdAvx512Ops<float, 4, true, true>
+{
+    static const size_t W = 16;
+
+    SIMD_TARGET_AVX512 static __m512i splat(float v) {return _mm512_castps_si512(_mm512_set1_ps(v));}
+
+    SIMD_TARGET_AVX512 static uint64_t eq(__m512i a, __m512i b)
+    {
+        return _mm512_cmp_ps_mask(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b), _CMP_EQ_OQ);
+    }
+
+    SIMD_TARGET_AVX512 static uint64_t lt(__m512i a, __m512i b)
+    {
+        return _mm512_cmp_ps_mask(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b), _CMP_LT_OQ);
+    }
+
+    SIMD_TARGET_AVX512 static uint64_t le(__m512i a, __m512i b)
+    {
+        return _mm512_cmp_ps_mask(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b), _CMP_LE_OQ);
+    }
+};
+
+template <> struct SimdAvx512Ops<double, 8, true, true>
+{
+    static const size_t W = 8;
+
+    SIMD_TARGET_AVX512 static __m512i splat(double v) {return _mm512_castpd_si512(_mm512_set1_pd(v));}
+
+    SIMD_TARGET_AVX512 static uint64_t eq(__m512i a, __m512i b)
+    {
+        return _mm512_cmp_pd_mask(_mm512_castsi512_pd(a), _mm512_castsi512_pd(b), _CMP_EQ_OQ);
+    }
+
+    SIMD_TARGET_AVX512 static uint64_t lt(__m512i a, __m512i b)
+    {
+        return _mm512_cmp_pd_mask(_mm512_castsi512_pd(a), _mm512_castsi512_pd(b), _CMP_LT_OQ);
+    }
+
+    SIMD_TARGET_AVX512 static uint64_t le(__m512i a, __m512i b)
+    {
+        return _mm512_cmp_pd_mask(_mm512_castsi512_pd(a), _mm512_castsi512_pd(b), _CMP_LE_OQ);
+    }
+};
+// @}
+
+#endif
+
+/**
+ * The predicates. Besides the scalar call operator each one evaluates a loaded vector of elements for each
+ * instruction set: avx2 returns a lane mask, avx512 an element mask.
+ */
+// @{
+
+/** Matches elements equal to the value. */
+template <class T>
+struct SimdEq : SimdPredicate
+{
+    typedef T ElemType;
+
+    T value; ///< The value to match.
+
+    explicit SimdEq(const T &value) : value(value) {}
+
+    bool operator()(const T &x) const {return x == value;}
+
+#ifdef SIMD_SEARCH_X86
+    SIMD_TARGET_AVX2 __m256i avx2(__m256i x) const
+    {
+        return SimdAvx2Ops<T>::eq(x, SimdAvx2Ops<T>::splat(value));
+    }
+
+    SIMD_TARGET_AVX512 uint64_t avx512(__m512i x) const
+    {
+        return SimdAvx512Ops<T>::eq(x, SimdAvx512Ops<T>::splat(value));
+    }
+#endif
+};
+
+/** Matches elements less than the value. */
+template <class T>
+struct SimdLt : SimdPredicate
+{
+    typedef T ElemType;
+
+    T value; ///< The upper bound, exclusive.
+
+    explicit SimdLt(const T &value) : value(value) {}
+
+    bool operator()(const T &x) const {return x < value;}
+
+#ifdef SIMD_SEARCH_X86
+    SIMD_TARGET_AVX2 __m256i avx2(__m256i x) const
+    {
+        return SimdAvx2Ops<T>::lt(x, SimdAvx2Ops<T>::splat(value));
+    }
+
+    SIMD_TARGET_AVX512 uint64_t avx512(__m512i x) const
+    {
+        return SimdAvx512Ops<T>::lt(x, SimdAvx512Ops<T>::splat(value));
+    }
+#endif
+};
+
+/** Matches elements greater than the value. */
+template <class T>
+struct SimdGt : SimdPredicate
+{
+    typedef T ElemType;
+
+    T value; ///< The lower bound, exclusive.
+
+    explicit SimdGt(const T &value) : value(value) {}
+
+    bool operator()(const T &x) const {return value < x;}
+
+#ifdef SIMD_SEARCH_X86
+    SIMD_TARGET_AVX2 __m256i avx2(__m256i x) const
+    {
+        return SimdAvx2Ops<T>::lt(SimdAvx2Ops<T>::splat(value), x);
+    }
+
+    SIMD_TARGET_AVX512 uint64_t avx512(__m512i x) const
+    {
+        return SimdAvx512Ops<T>::lt(SimdAvx512Ops<T>::splat(value), x);
+    }
+#endif
+};
+
+/** Matches elements in the closed range [low, high]. */
+template <class T>
+struct SimdBetween : SimdPredicate
+{
+    typedef T ElemType;
+
+    T low; ///< The lower bound, inclusive.
+    T high; ///< The upper bound, inclusive.
+
+    SimdBetween(const T &low, const T &high) : low(low), high(high) {}
+
+    bool operator()(const T &x) const {return (low <= x) && (x <= high);}
+
+#ifdef SIMD_SEARCH_X86
+    SIMD_TARGET_AVX2 __m256i avx2(__m256i x) const
+    {
+        typedef SimdAvx2Ops<T> Ops;
+
+        return _mm256_and_si256(Ops::le(Ops::splat(low), x), Ops::le(x, Ops::splat(high)));
+    }
+
+    SIMD_TARGET_AVX512 uint64_t avx512(__m512i x) const
+    {
+        typedef SimdAvx512Ops<T> Ops;
+
+        return Ops::le(Ops::splat(low), x) & Ops::le(x, Ops::splat(high));
+    }
+#endif
+};
+
+/** Matches elements equal to any of N values. */
+template <class T, size_t N>
+struct SimdInSet : SimdPredicate
+{
+    typedef T ElemType;
+
+    T values[N]; ///< The values to match.
+
+    template <class... Rest> explicit SimdInSet(const T &first, const Rest&... rest) : values{first, rest...} {}
+
+    bool operator()(const T &x) const
+    {
+        bool found = false;
+
+        for (size_t i = 0; i < N; i++) found |= (x == values[i]);
+
+        return found;
+    }
+
+#ifdef SIMD_SEARCH_X86
+    SIMD_TARGET_AVX2 __m256i avx2(__m256i x) const
+    {
+        typedef SimdAvx2Ops<T> Ops;
+        __m256i m = Ops::eq(x, Ops::splat(values[0]));
+
+        for (size_t i = 1; i < N; i++) m = _mm256_or_si256(m, Ops::eq(x, Ops::splat(values[i])));
+
+        return m;
+    }
+
+    SIMD_TARGET_AVX512 uint64_t avx512(__m512i x) const
+    {
+        typedef SimdAvx512Ops<T> Ops;
+        uint64_t m = 0;
+
+        for (size_t i = 0; i < N; i++) m |= Ops::eq(x, Ops::splat(values[i]));
+
+        return m;
+    }
+#endif
+};
+
+/** Matches elements matching both predicates. */
+template <class A, class B>
+struct SimdAnd : SimdPredicate
+{
+    typedef typename A::ElemType ElemType;
+    static_assert(std::is_same<ElemType, typename B::ElemType>::value, "The element types must be the same.");
+
+    A a;
+    B b;
+
+    SimdAnd(const A &a, const B &b) : a(a), b(b) {}
+
+    bool operator()(const ElemType &x) const {return a(x) && b(x);}
+
+#ifdef SIMD_SEARCH_X86
+    SIMD_TARGET_AVX2 __m256i avx2(__m256i x) const {return _mm256_and_si256(a.avx2(x), b.avx2(x));}
+    SIMD_TARGET_AVX512 uint64_t avx512(__m512i x) const {return a.avx512(x) & b.avx512(x);}
+#endif
+};
+
+/** Matches elements matching either predicate. */
+template <class A, class B>
+struct SimdOr : SimdPredicate
+{
+    typedef typename A::ElemType ElemType;
+    static_assert(std::is_same<ElemType, typename B::ElemType>::value, "The element types must be the same.");
+
+    A a;
+    B b;
+
+    SimdOr(const A &a, const B &b) : a(a), b(b) {}
+
+    bool operator()(const ElemType &x) const {return a(x) || b(x);}
+
+#ifdef SIMD_SEARCH_X86
+    SIMD_TARGET_AVX2 __m256i avx2(__m256i x) const {return _mm256_or_si256(a.avx2(x), b.avx2(x));}
+    SIMD_TARGET_AVX512 uint64_t avx512(__m512i x) const {return a.avx512(x) | b.avx512(x);}
+#endif
+};
+
+/** Matches elements not matching the predicate. */
+template <class A>
+struct SimdNot : SimdPredicate
+{
+    typedef typename A::ElemType ElemType;
+
+    A a;
+
+    explicit SimdNot(const A &a) : a(a) {}
+
+    bool operator()(const ElemType &x) const {return !a(x);}
+
+#ifdef SIMD_SEARCH_X86
+    SIMD_TARGET_AVX2 __m256i avx2(__m256i x) const {return _mm256_xor_si256(a.avx2(x), _mm256_set1_epi32(-1));}
+    SIMD_TARGET_AVX512 uint64_t avx512(__m512i x) const {return ~a.avx512(x);} // The kernels drop the extra bits.
+#endif
+};
+
+// @}
+
+/**
+ * Predicate builders.
+ */
+// @{
+template <class T> SimdEq<T> simdEq(const T &value) {return SimdEq<T>(value);}
+template <class T> SimdLt<T> simdLt(const T &value) {return SimdLt<T>(value);}
+template <class T> SimdGt<T> simdGt(const T &value) {return SimdGt<T>(value);}
+template <class T> SimdBetween<T> simdBetween(const T &low, const T &high) {return SimdBetween<T>(low, high);}
+
+template <class T, class... Rest> SimdInSet<T, 1 + sizeof...(Rest)> simdInSet(const T &first, const Rest&... rest)
+{
+    return SimdInSet<T, 1 + sizeof...(Rest)>(first, rest...);
+}
+
+template <class A, class B> SimdAnd<A, B> simdAnd(const A &a, const B &b) {return SimdAnd<A, B>(a, b);}
+template <class A, class B> SimdOr<A, B> simdOr(const A &a, const B &b) {return SimdOr<A, B>(a, b);}
+template <class A> SimdNot<A> simdNot(const A &a) {return SimdNot<A>(a);}
+// @}
+
+#ifdef SIMD_SEARCH_X86
+
+/**
+ * Permutation indexes for the AVX2 compress: for each 8 bit lane mask the indexes of the set lanes, packed to the
+ * front.
+ */
+struct SimdAvx2CompressTable
+{
+    uint32_t indexes[256][8];
+
+    SimdAvx2CompressTable()
+    {
+        for (int mask = 0; mask < 256; mask++)
+        {
+            int k = 0;
+
+            for (int lane = 0; lane < 8; lane++)
+            {
+                if (mask & (1 << lane)) indexes[mask][k++] = lane;
+            }
+
+            while (k < 8) indexes[mask][k++] = 0;
+        }
+    }
+};
+
+inline const SimdAvx2CompressTable &simdAvx2CompressTable()
+{
+    static const SimdAvx2CompressTable table;
+
+    return table;
+}
+
+/**
+ * Stores the elements of the vector at src selected by the element mask to out, packed. Returns the number stored.
+ *
+ * 4 and 8 byte elements are permuted in registers and stored as a whole vector, so up to a vector's worth of
+ * elements after the stored ones are overwritten. This is safe as long as out doesn't go beyond src, which is
+ * always the case when the output is at most as long as the input consumed so far.
+ */
+// @{
+template <class T> SIMD_TARGET_AVX2
+size_t simdAvx2CompressStore(T *out, const T *src, uint32_t mask, const SimdAvx2CompressTable &, std::false_type)
+{
+    size_t k = 0;
+
+    while (mask)
+    {
+        out[k++] = src[__builtin_ctz(mask)];
+        mask &= mask - 1;
+    }
+
+    return k;
+}
+
+template <class T> SIMD_TARGET_AVX2
+size_t simdAvx2CompressStore(T *out, const T *src, uint32_t mask, const SimdAvx2CompressTable &table, std::true_type)
+{
+    // 8 byte elements are two 32 bit lanes each.
+    uint32_t lanes = sizeof(T) == 4 ? mask : ((mask & 1) * 3) | ((mask & 2) * 6) | ((mask & 4) * 12) | ((mask & 8) * 24);
+    __m256i indexes = _mm256_loadu_si256((const __m256i*)table.indexes[lanes]);
+    __m256i packed = _mm256_permutevar8x32_epi32(_mm256_loadu_si256((const __m256i*)src), indexes);
+
+    _mm256_storeu_si256((__m256i*)out, packed);
+
+    return __builtin_popcount(mask);
+}
+// @}
+
+template <class T> SIMD_TARGET_AVX512 size_t simdAvx512CompressStore(T *out, const T *src, uint64_t mask)
+{
+    if (sizeof(T) == 4)
+    {
+        _mm512_storeu_si512(out, _mm512_maskz_compress_epi32((__mmask16)mask, _mm512_loadu_si512(src)));
+    }
+    else if (sizeof(T) == 8)
+    {
+        _mm512_storeu_si512(out, _mm512_maskz_compress_epi64((__mmask8)mask, _mm512_loadu_si512(src)));
+    }
+    else
+    {
+        // Compressing bytes and words needs AVX-512 VBMI2.
+        size_t k = 0;
+
+        while (mask)
+        {
+            out[k++] = src[__builtin_ctzll(mask)];
+            mask &= mask - 1;
+        }
+
+        return k;
+    }
+
+    return __builtin_popcountll(mask);
+}
+
+/**
+ * The AVX2 and AVX-512 kernels. The predicate is copied to a local, so the compiler can keep the broadcast
+ * operands in registers.
+ */
+// @{
+template <class T, class P> SIMD_TARGET_AVX2 ssize_t simdAvx2FindFirst(const T *buf, size_t n, const P &pred)
+{
+    typedef SimdAvx2Ops<T> Ops;
+    const P p = pred;
+    size_t i = 0;
+
+    for (; i + Ops::W <= n; i += Ops::W)
+    {
+        uint32_t m = Ops::bits(p.avx2(Ops::load(buf + i)));
+        if (m) return i + __builtin_ctz(m);
+    }
+
+    for (; i < n; i++)
+    {
+        if (p(buf[i])) return i;
+    }
+
+    return -1;
+}
+
+template <class T, class P> SIMD_TARGET_AVX2 ssize_t simdAvx2FindLast(const T *buf, size_t n, const P &pred)
+{
+    typedef SimdAvx2Ops<T> Ops;
+    const P p = pred;
+    size_t i = n;
+
+    for (size_t tail = n % Ops::W; tail; tail--)
+    {
+        i--;
+        if (p(buf[i])) return i;
+    }
+
+    while (i)
+    {
+        i -= Ops::W;
+
+        uint32_t m = Ops::bits(p.avx2(Ops::load(buf + i)));
+        if (m) return i + 31 - __builtin_clz(m);
+    }
+
+    return -1;
+}
+
+template <class T, class P>
+SIMD_TARGET_AVX2 size_t simdAvx2Compress(const T *buf, size_t n, const P &pred, bool keep, T *out)
+{
+    typedef SimdAvx2Ops<T> Ops;
+    typedef std::integral_constant<bool, (sizeof(T) == 4) || (sizeof(T) == 8)> Permute;
+    const P p = pred;
+    const SimdAvx2CompressTable &table = simdAvx2CompressTable();
+    const uint32_t all = Ops::W == 32 ? ~0u : (1u << Ops::W) - 1;
+    const uint32_t flip = keep ? 0 : all;
+    size_t k = 0;
+    size_t i = 0;
+
+    for (; i + Ops::W <= n; i += Ops::W)
+    {
+        uint32_t m = Ops::bits(p.avx2(Ops::load(buf + i))) ^ flip;
+
+        k += simdAvx2CompressStore(out + k, buf + i, m, table, Permute());
+    }
+
+    for (; i < n; i++)
+    {
+        T x = buf[i];
+
+        out[k] = x;
+        k += (static_cast<bool>(p(x)) == keep);
+    }
+
+    return k;
+}
+
+template <class T, class P> SIMD_TARGET_AVX512 ssize_t simdAvx512FindFirst(const T *buf, size_t n, const P &pred)
+{
+    typedef SimdAvx512Ops<T> Ops;
+    const P p = pred;
+    const uint64_t all = Ops::W == 64 ? ~0ull : (1ull << Ops::W) - 1;
+    size_t i = 0;
+
+    for (; i + Ops::W <= n; i += Ops::W)
+    {
+        uint64_t m = p.avx512(_mm512_loadu_si512(buf + i)) & all;
+        if (m) return i + __builtin_ctzll(m);
+    }
+
+    for (; i < n; i++)
+    {
+        if (p(buf[i])) return i;
+    }
+
+    return -1;
+}
+
+template <class T, class P> SIMD_TARGET_AVX512 ssize_t simdAvx512FindLast(const T *buf, size_t n, const P &pred)
+{
+    typedef SimdAvx512Ops<T> Ops;
+    const P p = pred;
+    const uint64_t all = Ops::W == 64 ? ~0ull : (1ull << Ops::W) - 1;
+    size_t i = n;
+
+    for (size_t tail = n % Ops::W; tail; tail--)
+    {
+        i--;
+        if (p(buf[i])) return i;
+    }
+
+    while (i)
+    {
+        i -= Ops::W;
+
+        uint64_t m = p.avx512(_mm512_loadu_si512(buf + i)) & all;
+        if (m) return i + 63 - __builtin_clzll(m);
+    }
+
+    return -1;
+}
+
+template <class T, class P>
+SIMD_TARGET_AVX512 size_t simdAvx512Compress(const T *buf, size_t n, const P &pred, bool keep, T *out)
+{
+    typedef SimdAvx512Ops<T> Ops;
+    const P p = pred;
+    const uint64_t all = Ops::W == 64 ? ~0ull : (1ull << Ops::W) - 1;
+    const uint64_t flip = keep ? 0 : all;
+    size_t k = 0;
+    size_t i = 0;
+
+    for (; i + Ops::W <= n; i += Ops::W)
+    {
+        uint64_t m = (p.avx512(_mm512_loadu_si512(buf + i)) ^ flip) & all;
+
+        k += simdAvx512CompressStore(out + k, buf + i, m);
+    }
+
+    for (; i < n; i++)
+    {
+        T x = buf[i];
+
+        out[k] = x;
+        k += (static_cast<bool>(p(x)) == keep);
+    }
+
+    return k;
+}
+// @}
+
+#endif
+
+/**
+ * The simdFindFirst, simdFindLast and simdCompress implementations for vectorizable and other predicates.
+ */
+// @{
+template <class T, class P> ssize_t simdFindFirst(const T *buf, size_t n, const P &p, std::false_type)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (p(buf[i])) return i;
+    }
+
+    return -1;
+}
+
+template <class T, class P> ssize_t simdFindFirst(const T *buf, size_t n, const P &p, std::true_type)
+{
+#ifdef SIMD_SEARCH_X86
+    switch (simdGetLevel())
+    {
+        case SimdLevel::AVX512: return simdAvx512FindFirst(buf, n, p);
+        case SimdLevel::AVX2: return simdAvx2FindFirst(buf, n, p);
+        default: break;
+    }
+#endif
+
+    return simdFindFirst(buf, n, p, std::false_type());
+}
+
+template <class T, class P> ssize_t simdFindLast(const T *buf, size_t n, const P &p, std::false_type)
+{
+    for (size_t i = n; i --> 0;)
+    {
+        if (p(buf[i])) return i;
+    }
+
+    return -1;
+}
+
+template <class T, class P> ssize_t simdFindLast(const T *buf, size_t n, const P &p, std::true_type)
+{
+#ifdef SIMD_SEARCH_X86
+    switch (simdGetLevel())
+    {
+        case SimdLevel::AVX512: return simdAvx512FindLast(buf, n, p);
+        case SimdLevel::AVX2: return simdAvx2FindLast(buf, n, p);
+        default: break;
+    }
+#endif
+
+    return simdFindLast(buf, n, p, std::false_type());
+}
+
+template <class T, class P> size_t simdCompress(const T *buf, size_t n, const P &p, bool keep, T *out, std::false_type)
+{
+    size_t k = 0;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        T x = buf[i];
+
+        out[k] = x;
+        k += (static_cast<bool>(p(x)) == keep);
+    }
+
+    return k;
+}
+
+template <class T, class P> size_t simdCompress(const T *buf, size_t n, const P &p, bool keep, T *out, std::true_type)
+{
+#ifdef SIMD_SEARCH_X86
+    switch (simdGetLevel())
+    {
+        case SimdLevel::AVX512: return simdAvx512Compress(buf, n, p, keep, out);
+        case SimdLevel::AVX2: return simdAvx2Compress(buf, n, p, keep, out);
+        default: break;
+    }
+#endif
+
+    return simdCompress(buf, n, p, keep, out, std::false_type());
+}
+// @}
+
+/**
+ * Finds the first element matching the predicate.
+ *
+ * @returns The index of the first match, -1 if there is none.
+ */
+// @{
+template <class T, class P> ssize_t simdFindFirst(const T *buf, size_t n, const P &p)
+{
+    return simdFindFirst(buf, n, p, SimdPredicateFor<P, T>());
+}
+
+template <class T> ssize_t simdFindFirst(const T *buf, size_t n, const SimdEq<T> &p)
+{
+    return simdIndexOf(buf, n, p.value);
+}
+// @}
+
+/**
+ * Finds the last element matching the predicate.
+ *
+ * @returns The index of the last match, -1 if there is none.
+ */
+// @{
+template <class T, class P> ssize_t simdFindLast(const T *buf, size_t n, const P &p)
+{
+    return simdFindLast(buf, n, p, SimdPredicateFor<P, T>());
+}
+
+template <class T> ssize_t simdFindLast(const T *buf, size_t n, const SimdEq<T> &p)
+{
+    return simdLastIndexOf(buf, n, p.value);
+}
+// @}
+
+/**
+ * Copies the elements matching (or not matching) the predicate to out, keeping their order.
+ *
+ * @param[in] buf The elements. Must be trivially copyable.
+ * @param[in] n The number of elements.
+ * @param[in] p The predicate.
+ * @param[in] keep True to copy the matching elements, false to copy the rest.
+ * @param[out] out The destination. It can be buf itself to filter in place, otherwise it must not overlap buf and
+ *      must have room for n elements, as elements after the copied ones may be overwritten.
+ * @returns The number of elements copied.
+ */
+template <class T, class P> size_t simdCompress(const T *buf, size_t n, const P &p, bool keep, T *out)
+{
+    return simdCompress(buf, n, p, keep, out, SimdPredicateFor<P, T>());
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifdef BENCHMARK
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "benchmark.h"
+#include "dynamic_array.h"
+
+template <class T>
+struct Alloc
+{
+    T *allocate(size_t n) {return (T*)malloc(n * sizeof(T));}
+    T *reallocate(T* buf, size_t n) {return (T*)realloc(buf, n * sizeof(T));}
+    void deallocate(T *buf) {free(buf);}
+};
+
+typedef DynArray<int32_t, Alloc<int32_t>> List;
+
+/**
+ * Runs the same search with a lambda and with the equivalent vectorized predicate. Each measurement selects about
+ * half of the elements in a random pattern, so the lambda path can't predict its branches.
+ */
+template <class Lambda, class Predicate>
+static void benchPair(const char *what, List &list, size_t repeats, const Lambda &lambda, const Predicate &pred)
+{
+    char name[64];
+    size_t count = list.getCount();
+
+    snprintf(name, sizeof(name), "%s, lambda", what);
+    double start = benchNow();
+    for (size_t r = 0; r < repeats; r++)
+    {
+        List found = list.findAll(lambda);
+        benchKeep(found.getCount());
+    }
+    benchReport(name, benchNow() - start, repeats * count);
+
+    snprintf(name, sizeof(name), "%s, simd", what);
+    start = benchNow();
+    for (size_t r = 0; r < repeats; r++)
+    {
+        List found = list.findAll(pred);
+        benchKeep(found.getCount());
+    }
+    benchReport(name, benchNow() - start, repeats * count);
+}
+
+/**
+ * Scans for a predicate that never matches, so the whole array is read.
+ */
+template <class Lambda, class Predicate>
+static void benchExists(const char *what, List &list, size_t repeats, const Lambda &lambda, const Predicate &pred)
+{
+    char name[64];
+    size_t count = list.getCount();
+
+    snprintf(name, sizeof(name), "%s, lambda", what);
+    double start = benchNow();
+    for (size_t r = 0; r < repeats; r++) benchKeep(list.exists(lambda));
+    benchReport(name, benchNow() - start, repeats * count);
+
+    snprintf(name, sizeof(name), "%s, simd", what);
+    start = benchNow();
+    for (size_t r = 0; r < repeats; r++) benchKeep(list.exists(pred));
+    benchReport(name, benchNow() - start, repeats * count);
+}
+
+int main(int argc, char **argv)
+{
+    size_t total = argc > 1 ? strtoull(argv[1], nullptr, 10) : 200000000;
+    const size_t count = 1000000;
+    size_t repeats = total / count;
+    List list;
+
+    srand(1);
+    for (size_t i = 0; i < count; i++) list.add(rand() % 1000);
+
+    printf("Detected level: %d\n", (int)simdDetectLevel());
+
+    benchPair("findAll x < 500", list, repeats,
+        [](int32_t x) {return x < 500;}, simdLt(500));
+    benchPair("findAll 250 <= x <= 749", list, repeats,
+        [](int32_t x) {return (250 <= x) && (x <= 749);}, simdBetween(250, 749));
+    benchPair("findAll x < 250 || x > 749", list, repeats,
+        [](int32_t x) {return (x < 250) || (x > 749);}, simdOr(simdLt(250), simdGt(749)));
+    benchExists("exists x in {-1, -2, -3}", list, repeats,
+        [](int32_t x) {return (x == -1) || (x == -2) || (x == -3);}, simdInSet(-1, -2, -3));
+    benchExists("exists !(0 <= x <= 999)", list, repeats,
+        [](int32_t x) {return !((0 <= x) && (x <= 999));}, simdNot(simdBetween(0, 999)));
+
+    return 0;
+}
+
+#endif
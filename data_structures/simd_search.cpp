@@ -0,0 +1,132 @@
+#ifdef UNIT_TEST
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include <math.h>
+
+#include "simd_search.h"
+
+template <class T> ssize_t referenceIndexOf(const T *buf, size_t n, T value)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (buf[i] == value) return i;
+    }
+
+    return -1;
+}
+
+template <class T> ssize_t referenceLastIndexOf(const T *buf, size_t n, T value)
+{
+    for (size_t i = n; i --> 0;)
+    {
+        if (buf[i] == value) return i;
+    }
+
+    return -1;
+}
+
+/**
+ * Searches every length up to 300 with the matches placed at every position, from an unaligned start too, and
+ * compares the results with a plain loop.
+ */
+template <class T> void testType(T base)
+{
+    static T storage[301];
+    T needle = (T)(base + 1);
+
+    for (size_t n = 0; n <= 300; n++)
+    {
+        T *buf = storage + (n & 1); // Unaligned every second time.
+
+        for (size_t i = 0; i < n; i++) buf[i] = (T)(base + 2 + (i % 7)); // Never equal to the needle.
+
+        assert(simdIndexOf(buf, n, needle) == -1);
+        assert(simdLastIndexOf(buf, n, needle) == -1);
+
+        for (size_t pos = 0; pos < n; pos += (n < 80 ? 1 : 13))
+        {
+            buf[pos] = needle;
+            buf[n - 1 - pos / 2] = needle;
+
+            assert(simdIndexOf(buf, n, needle) == referenceIndexOf(buf, n, needle));
+            assert(simdLastIndexOf(buf, n, needle) == referenceLastIndexOf(buf, n, needle));
+
+            buf[pos] = (T)(base + 2);
+            buf[n - 1 - pos / 2] = (T)(base + 2);
+        }
+    }
+}
+
+template <class T> void testFloat()
+{
+    T buf[100];
+
+    for (size_t i = 0; i < 100; i++) buf[i] = (T)i;
+
+    buf[40] = (T)NAN;
+    buf[70] = (T)-0.0;
+    buf[0] = 1; // Now 0.0 is only present as -0.0.
+
+    assert(simdIndexOf(buf, 100, (T)NAN) == -1);
+    assert(simdIndexOf(buf, 100, (T)0.0) == 70);
+    assert(simdLastIndexOf(buf, 100, (T)-0.0) == 70);
+    assert(simdIndexOf(buf, 100, (T)1) == 0);
+    assert(simdLastIndexOf(buf, 100, (T)1) == 1);
+}
+
+struct Point
+{
+    int x, y;
+
+    bool operator==(const Point &other) const {return (x == other.x) && (y == other.y);}
+};
+
+int main()
+{
+    static_assert(SimdSearchable<int>::value, "");
+    static_assert(SimdSearchable<uint64_t>::value, "");
+    static_assert(SimdSearchable<double>::value, "");
+    static_assert(!SimdSearchable<bool>::value, "");
+    static_assert(!SimdSearchable<long double>::value, "");
+    static_assert(!SimdSearchable<Point>::value, "");
+
+    SimdLevel detected = simdDetectLevel();
+    printf("Detected level: %d\n", (int)detected);
+
+    for (int level = (int)SimdLevel::SCALAR; level <= (int)detected; level++)
+    {
+        assert(simdSetLevel((SimdLevel)level) == (SimdLevel)level);
+
+        testType<int8_t>(-100);
+        testType<uint8_t>(200);
+        testType<int16_t>(-1000);
+        testType<uint16_t>(60000);
+        testType<int32_t>(-5);
+        testType<uint32_t>(4000000000u);
+        testType<int64_t>(-(1ll << 40));
+        testType<uint64_t>(1ull << 63);
+        testType<float>(0.5f);
+        testType<double>(-0.25);
+        testFloat<float>();
+        testFloat<double>();
+    }
+
+    assert(simdSetLevel(SimdLevel::AVX512) == detected);
+
+    // The 64 bit compare must not match when only one half is equal.
+    uint64_t halves[8] = {0x100000002ull, 0x200000001ull, 0, 0, 0, 0, 0, 0x100000001ull};
+    assert(simdIndexOf(halves, 8, (uint64_t)0x100000001ull) == 7);
+
+    Point points[3] = {{1, 2}, {3, 4}, {1, 2}};
+    assert(simdIndexOf(points, 3, Point{1, 2}) == 0);
+    assert(simdLastIndexOf(points, 3, Point{1, 2}) == 2);
+    assert(simdIndexOf(points, 3, Point{2, 1}) == -1);
+
+    printf("Passed: %s %s\n", __DATE__, __TIME__);
+
+    return 0;
+}
+
+#endif
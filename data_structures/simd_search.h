@@ -0,0 +1,607 @@
+#ifndef SIMD_SEARCH_H
+#define SIMD_SEARCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_SEARCH_X86
+#define SIMD_TARGET_SSE2 __attribute__((target("sse2")))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f,avx512bw")))
+#endif
+
+/**
+ * Vectorized linear search for arithmetic element types.
+ *
+ * The kernels are compiled for SSE2, AVX2 and AVX-512 with target attributes, so no special compiler flags are
+ * needed. The best one the CPU supports is picked at runtime, types that aren't integers or floating point numbers
+ * use a plain loop.
+ *
+ * Equality works the same as operator== on the element type: for floating point NaN never matches and -0.0 matches
+ * 0.0.
+ */
+
+/** The instruction set levels of the search kernels. */
+enum class SimdLevel
+{
+    SCALAR, ///< Plain loop.
+    SSE2, ///< 16 byte vectors.
+    AVX2, ///< 32 byte vectors.
+    AVX512 ///< 64 byte vectors, needs AVX-512F and AVX-512BW.
+};
+
+/**
+ * @returns The best level the CPU supports.
+ */
+inline SimdLevel simdDetectLevel()
+{
+#ifdef SIMD_SEARCH_X86
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) return SimdLevel::AVX512;
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse2")) return SimdLevel::SSE2;
+#endif
+
+    return SimdLevel::SCALAR;
+}
+
+/**
+ * The level used by the searches, detected on first use.
+ */
+inline SimdLevel &simdLevelRef()
+{
+    static SimdLevel level = simdDetectLevel();
+
+    return level;
+}
+
+/**
+ * @returns The level the searches use.
+ */
+inline SimdLevel simdGetLevel()
+{
+    return simdLevelRef();
+}
+
+/**
+ * Overrides the level the searches use, for testing and benchmarking the kernels against each other.
+ *
+ * @param[in] level The requested level. Levels the CPU doesn't support are lowered to the best supported one.
+ * @returns The level set.
+ *
+ * @remarks
+ *  Not thread safe, call it before starting threads that search.
+ */
+inline SimdLevel simdSetLevel(SimdLevel level)
+{
+    SimdLevel supported = simdDetectLevel();
+
+    simdLevelRef() = level < supported ? level : supported;
+
+    return simdLevelRef();
+}
+
+/** Maps a size to the unsigned integer of that size. */
+// @{
+template <size_t Size> struct SimdUnsigned {typedef void Type;};
+template <> struct SimdUnsigned<1> {typedef uint8_t Type;};
+template <> struct SimdUnsigned<2> {typedef uint16_t Type;};
+template <> struct SimdUnsigned<4> {typedef uint32_t Type;};
+template <> struct SimdUnsigned<8> {typedef uint64_t Type;};
+// @}
+
+/**
+ * The lane type the kernels handle T as: integers are compared as unsigned integers of the same size, float and
+ * double as themselves. void if T can't be searched with the kernels.
+ */
+// @{
+template <class T, bool Integral = std::is_integral<T>::value && !std::is_same<T, bool>::value>
+struct SimdLane {typedef void Type;};
+
+template <class T> struct SimdLane<T, true> {typedef typename SimdUnsigned<sizeof(T)>::Type Type;};
+template <> struct SimdLane<float, false> {typedef float Type;};
+template <> struct SimdLane<double, false> {typedef double Type;};
+// @}
+
+/**
+ * Tells whether T is searched with the vector kernels.
+ */
+template <class T>
+struct SimdSearchable : std::integral_constant<bool, !std::is_void<typename SimdLane<T>::Type>::value> {};
+
+#ifdef SIMD_SEARCH_X86
+
+/**
+ * SSE2 kernels. The comparisons return a byte mask: sizeof(L) bits per element.
+ */
+// @{
+SIMD_TARGET_SSE2 inline __m128i simdSse2Splat(uint8_t v) {return _mm_set1_epi8((char)v);}
+SIMD_TARGET_SSE2 inline __m128i simdSse2Splat(uint16_t v) {return _mm_set1_epi16((short)v);}
+SIMD_TARGET_SSE2 inline __m128i simdSse2Splat(uint32_t v) {return _mm_set1_epi32((int)v);}
+SIMD_TARGET_SSE2 inline __m128i simdSse2Splat(uint64_t v) {return _mm_set1_epi64x((long long)v);}
+SIMD_TARGET_SSE2 inline __m128i simdSse2Splat(float v) {return _mm_castps_si128(_mm_set1_ps(v));}
+SIMD_TARGET_SSE2 inline __m128i simdSse2Splat(double v) {return _mm_castpd_si128(_mm_set1_pd(v));}
+
+SIMD_TARGET_SSE2 inline uint32_t simdSse2Eq(const uint8_t *p, __m128i needle)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)p), needle));
+}
+
+SIMD_TARGET_SSE2 inline uint32_t simdSse2Eq(const uint16_t *p, __m128i needle)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_loadu_si128((const __m128i*)p), needle));
+}
+
+SIMD_TARGET_SSE2 inline uint32_t simdSse2Eq(const uint32_t *p, __m128i needle)
+{
+    return _mm_movemask_epi8(_mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)p), needle));
+}
+
+SIMD_TARGET_SSE2 inline uint32_t simdSse2Eq(const uint64_t *p, __m128i needle)
+{
+    // No 64 bit compare in SSE2: both 32 bit halves must match.
+    __m128i eq = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)p), needle);
+
+    return _mm_movemask_epi8(_mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1))));
+}
+
+SIMD_TARGET_SSE2 inline uint32_t simdSse2Eq(const float *p, __m128i needle)
+{
+    return _mm_movemask_epi8(_mm_castps_si128(_mm_cmpeq_ps(_mm_loadu_ps(p), _mm_castsi128_ps(needle))));
+}
+
+SIMD_TARGET_SSE2 inline uint32_t simdSse2Eq(const double *p, __m128i needle)
+{
+    return _mm_movemask_epi8(_mm_castpd_si128(_mm_cmpeq_pd(_mm_loadu_pd(p), _mm_castsi128_pd(needle))));
+}
+
+template <class L> SIMD_TARGET_SSE2 ssize_t simdSse2IndexOf(const L *buf, size_t n, L value)
+{
+    const size_t W = 16 / sizeof(L);
+    __m128i needle = simdSse2Splat(value);
+    size_t i = 0;
+
+    for (; i + 4 * W <= n; i += 4 * W)
+    {
+        uint32_t m0 = simdSse2Eq(buf + i, needle);
+        uint32_t m1 = simdSse2Eq(buf + i + W, needle);
+        uint32_t m2 = simdSse2Eq(buf + i + 2 * W, needle);
+        uint32_t m3 = simdSse2Eq(buf + i + 3 * W, needle);
+
+        if (m0 | m1 | m2 | m3)
+        {
+            if (m0) return i + __builtin_ctz(m0) / sizeof(L);
+            if (m1) return i + W + __builtin_ctz(m1) / sizeof(L);
+            if (m2) return i + 2 * W + __builtin_ctz(m2) / sizeof(L);
+            return i + 3 * W + __builtin_ctz(m3) / sizeof(L);
+        }
+    }
+
+    for (; i + W <= n; i += W)
+    {
+        uint32_t m = simdSse2Eq(buf + i, needle);
+        if (m) return i + __builtin_ctz(m) / sizeof(L);
+    }
+
+    for (; i < n; i++)
+    {
+        if (buf[i] == value) return i;
+    }
+
+    return -1;
+}
+
+template <class L> SIMD_TARGET_SSE2 ssize_t simdSse2LastIndexOf(const L *buf, size_t n, L value)
+{
+    const size_t W = 16 / sizeof(L);
+    __m128i needle = simdSse2Splat(value);
+    size_t i = n;
+
+    for (; i >= 4 * W; i -= 4 * W)
+    {
+        const L *p = buf + i - 4 * W;
+        uint32_t m0 = simdSse2Eq(p, needle);
+        uint32_t m1 = simdSse2Eq(p + W, needle);
+        uint32_t m2 = simdSse2Eq(p + 2 * W, needle);
+        uint32_t m3 = simdSse2Eq(p + 3 * W, needle);
+
+        if (m0 | m1 | m2 | m3)
+        {
+            size_t base = i - 4 * W;
+
+            if (m3) return base + 3 * W + (31 - __builtin_clz(m3)) / sizeof(L);
+            if (m2) return base + 2 * W + (31 - __builtin_clz(m2)) / sizeof(L);
+            if (m1) return base + W + (31 - __builtin_clz(m1)) / sizeof(L);
+            return base + (31 - __builtin_clz(m0)) / sizeof(L);
+        }
+    }
+
+    for (; i >= W; i -= W)
+    {
+        uint32_t m = simdSse2Eq(buf + i - W, needle);
+        if (m) return i - W + (31 - __builtin_clz(m)) / sizeof(L);
+    }
+
+    while (i --> 0)
+    {
+        if (buf[i] == value) return i;
+    }
+
+    return -1;
+}
+// @}
+
+/**
+ * AVX2 kernels. The comparisons return a byte mask: sizeof(L) bits per element.
+ */
+// @{
+SIMD_TARGET_AVX2 inline __m256i simdAvx2Splat(uint8_t v) {return _mm256_set1_epi8((char)v);}
+SIMD_TARGET_AVX2 inline __m256i simdAvx2Splat(uint16_t v) {return _mm256_set1_epi16((short)v);}
+SIMD_TARGET_AVX2 inline __m256i simdAvx2Splat(uint32_t v) {return _mm256_set1_epi32((int)v);}
+SIMD_TARGET_AVX2 inline __m256i simdAvx2Splat(uint64_t v) {return _mm256_set1_epi64x((long long)v);}
+SIMD_TARGET_AVX2 inline __m256i simdAvx2Splat(float v) {return _mm256_castps_si256(_mm256_set1_ps(v));}
+SIMD_TARGET_AVX2 inline __m256i simdAvx2Splat(double v) {return _mm256_castpd_si256(_mm256_set1_pd(v));}
+
+SIMD_TARGET_AVX2 inline uint32_t simdAvx2Eq(const uint8_t *p, __m256i needle)
+{
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)p), needle));
+}
+
+SIMD_TARGET_AVX2 inline uint32_t simdAvx2Eq(const uint16_t *p, __m256i needle)
+{
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_loadu_si256((const __m256i*)p), needle));
+}
+
+SIMD_TARGET_AVX2 inline uint32_t simdAvx2Eq(const uint32_t *p, __m256i needle)
+{
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)p), needle));
+}
+
+SIMD_TARGET_AVX2 inline uint32_t simdAvx2Eq(const uint64_t *p, __m256i needle)
+{
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i*)p), needle));
+}
+
+SIMD_TARGET_AVX2 inline uint32_t simdAvx2Eq(const float *p, __m256i needle)
+{
+    __m256 eq = _mm256_cmp_ps(_mm256_loadu_ps(p), _mm256_castsi256_ps(needle), _CMP_EQ_OQ);
+
+    return _mm256_movemask_epi8(_mm256_castps_si256(eq));
+}
+
+SIMD_TARGET_AVX2 inline uint32_t simdAvx2Eq(const double *p, __m256i needle)
+{
+    __m256d eq = _mm256_cmp_pd(_mm256_loadu_pd(p), _mm256_castsi256_pd(needle), _CMP_EQ_OQ);
+
+    return _mm256_movemask_epi8(_mm256_castpd_si256(eq));
+}
+
+template <class L> SIMD_TARGET_AVX2 ssize_t simdAvx2IndexOf(const L *buf, size_t n, L value)
+{
+    const size_t W = 32 / sizeof(L);
+    __m256i needle = simdAvx2Splat(value);
+    size_t i = 0;
+
+    for (; i + 4 * W <= n; i += 4 * W)
+    {
+        uint32_t m0 = simdAvx2Eq(buf + i, needle);
+        uint32_t m1 = simdAvx2Eq(buf + i + W, needle);
+        uint32_t m2 = simdAvx2Eq(buf + i + 2 * W, needle);
+        uint32_t m3 = simdAvx2Eq(buf + i + 3 * W, needle);
+
+        if (m0 | m1 | m2 | m3)
+        {
+            if (m0) return i + __builtin_ctz(m0) / sizeof(L);
+            if (m1) return i + W + __builtin_ctz(m1) / sizeof(L);
+            if (m2) return i + 2 * W + __builtin_ctz(m2) / sizeof(L);
+            return i + 3 * W + __builtin_ctz(m3) / sizeof(L);
+        }
+    }
+
+    for (; i + W <= n; i += W)
+    {
+        uint32_t m = simdAvx2Eq(buf + i, needle);
+        if (m) return i + __builtin_ctz(m) / sizeof(L);
+    }
+
+    for (; i < n; i++)
+    {
+        if (buf[i] == value) return i;
+    }
+
+    return -1;
+}
+
+template <class L> SIMD_TARGET_AVX2 ssize_t simdAvx2LastIndexOf(const L *buf, size_t n, L value)
+{
+    const size_t W = 32 / sizeof(L);
+    __m256i needle = simdAvx2Splat(value);
+    size_t i = n;
+
+    for (; i >= 4 * W; i -= 4 * W)
+    {
+        const L *p = buf + i - 4 * W;
+        uint32_t m0 = simdAvx2Eq(p, needle);
+        uint32_t m1 = simdAvx2Eq(p + W, needle);
+        uint32_t m2 = simdAvx2Eq(p + 2 * W, needle);
+        uint32_t m3 = simdAvx2Eq(p + 3 * W, needle);
+
+        if (m0 | m1 | m2 | m3)
+        {
+            size_t base = i - 4 * W;
+
+            if (m3) return base + 3 * W + (31 - __builtin_clz(m3)) / sizeof(L);
+            if (m2) return base + 2 * W + (31 - __builtin_clz(m2)) / sizeof(L);
+            if (m1) return base + W + (31 - __builtin_clz(m1)) / sizeof(L);
+            return base + (31 - __builtin_clz(m0)) / sizeof(L);
+        }
+    }
+
+    for (; i >= W; i -= W)
+    {
+        uint32_t m = simdAvx2Eq(buf + i - W, needle);
+        if (m) return i - W + (31 - __builtin_clz(m)) / sizeof(L);
+    }
+
+    while (i --> 0)
+    {
+        if (buf[i] == value) return i;
+    }
+
+    return -1;
+}
+// @}
+
+/**
+ * AVX-512 kernels. The comparisons return an element mask: one bit per element.
+ */
+// @{
+SIMD_TARGET_AVX512 inline __m512i simdAvx512Splat(uint8_t v) {return _mm512_set1_epi8((char)v);}
+SIMD_TARGET_AVX512 inline __m512i simdAvx512Splat(uint16_t v) {return _mm512_set1_epi16((short)v);}
+SIMD_TARGET_AVX512 inline __m512i simdAvx512Splat(uint32_t v) {return _mm512_set1_epi32((int)v);}
+SIMD_TARGET_AVX512 inline __m512i simdAvx512Splat(uint64_t v) {return _mm512_set1_epi64((long long)v);}
+SIMD_TARGET_AVX512 inline __m512i simdAvx512Splat(float v) {return _mm512_castps_si512(_mm512_set1_ps(v));}
+SIMD_TARGET_AVX512 inline __m512i simdAvx512Splat(double v) {return _mm512_castpd_si512(_mm512_set1_pd(v));}
+
+SIMD_TARGET_AVX512 inline uint64_t simdAvx512Eq(const uint8_t *p, __m512i needle)
+{
+    return _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(p), needle);
+}
+
+SIMD_TARGET_AVX512 inline uint64_t simdAvx512Eq(const uint16_t *p, __m512i needle)
+{
+    return _mm512_cmpeq_epi16_mask(_mm512_loadu_si512(p), needle);
+}
+
+SIMD_TARGET_AVX512 inline uint64_t simdAvx512Eq(const uint32_t *p, __m512i needle)
+{
+    return _mm512_cmpeq_epi32_mask(_mm512_loadu_si512(p), needle);
+}
+
+SIMD_TARGET_AVX512 inline uint64_t simdAvx512Eq(const uint64_t *p, __m512i needle)
+{
+    return _mm512_cmpeq_epi64_mask(_mm512_loadu_si512(p), needle);
+}
+
+SIMD_TARGET_AVX512 inline uint64_t simdAvx512Eq(const float *p, __m512i needle)
+{
+    return _mm512_cmp_ps_mask(_mm512_loadu_ps(p), _mm512_castsi512_ps(needle), _CMP_EQ_OQ);
+}
+
+SIMD_TARGET_AVX512 inline uint64_t simdAvx512Eq(const double *p, __m512i needle)
+{
+    return _mm512_cmp_pd_mask(_mm512_loadu_pd(p), _mm512_castsi512_pd(needle), _CMP_EQ_OQ);
+}
+
+template <class L> SIMD_TARGET_AVX512 ssize_t simdAvx512IndexOf(const L *buf, size_t n, L value)
+{
+    const size_t W = 64 / sizeof(L);
+    __m512i needle = simdAvx512Splat(value);
+    size_t i = 0;
+
+    for (; i + 4 * W <= n; i += 4 * W)
+    {
+        uint64_t m0 = simdAvx512Eq(buf + i, needle);
+        uint64_t m1 = simdAvx512Eq(buf + i + W, needle);
+        uint64_t m2 = simdAvx512Eq(buf + i + 2 * W, needle);
+        uint64_t m3 = simdAvx512Eq(buf + i + 3 * W, needle);
+
+        if (m0 | m1 | m2 | m3)
+        {
+            if (m0) return i + __builtin_ctzll(m0);
+            if (m1) return i + W + __builtin_ctzll(m1);
+            if (m2) return i + 2 * W + __builtin_ctzll(m2);
+            return i + 3 * W + __builtin_ctzll(m3);
+        }
+    }
+
+    for (; i + W <= n; i += W)
+    {
+        uint64_t m = simdAvx512Eq(buf + i, needle);
+        if (m) return i + __builtin_ctzll(m);
+    }
+
+    for (; i < n; i++)
+    {
+        if (buf[i] == value) return i;
+    }
+
+    return -1;
+}
+
+template <class L> SIMD_TARGET_AVX512 ssize_t simdAvx512LastIndexOf(const L *buf, size_t n, L value)
+{
+    const size_t W = 64 / sizeof(L);
+    __m512i needle = simdAvx512Splat(value);
+    size_t i = n;
+
+    for (; i >= 4 * W; i -= 4 * W)
+    {
+        const L *p = buf + i - 4 * W;
+        uint64_t m0 = simdAvx512Eq(p, needle);
+        uint64_t m1 = simdAvx512Eq(p + W, needle);
+        uint64_t m2 = simdAvx512Eq(p + 2 * W, needle);
+        uint64_t m3 = simdAvx512Eq(p + 3 * W, needle);
+
+        if (m0 | m1 | m2 | m3)
+        {
+            size_t base = i - 4 * W;
+
+            if (m3) return base + 3 * W + (63 - __builtin_clzll(m3));
+            if (m2) return base + 2 * W + (63 - __builtin_clzll(m2));
+            if (m1) return base + W + (63 - __builtin_clzll(m1));
+            return base + (63 - __builtin_clzll(m0));
+        }
+    }
+
+    for (; i >= W; i -= W)
+    {
+        uint64_t m = simdAvx512Eq(buf + i - W, needle);
+        if (m) return i - W + (63 - __builtin_clzll(m));
+    }
+
+    while (i --> 0)
+    {
+        if (buf[i] == value) return i;
+    }
+
+    return -1;
+}
+// @}
+
+#endif
+
+/**
+ * Dispatches to the kernel of the current level.
+ */
+// @{
+template <class L> ssize_t simdLaneIndexOf(const L *buf, size_t n, L value)
+{
+#ifdef SIMD_SEARCH_X86
+    switch (simdGetLevel())
+    {
+        case SimdLevel::AVX512: return simdAvx512IndexOf(buf, n, value);
+        case SimdLevel::AVX2: return simdAvx2IndexOf(buf, n, value);
+        case SimdLevel::SSE2: return simdSse2IndexOf(buf, n, value);
+        case SimdLevel::SCALAR: break;
+    }
+#endif
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (buf[i] == value) return i;
+    }
+
+    return -1;
+}
+
+template <class L> ssize_t simdLaneLastIndexOf(const L *buf, size_t n, L value)
+{
+#ifdef SIMD_SEARCH_X86
+    switch (simdGetLevel())
+    {
+        case SimdLevel::AVX512: return simdAvx512LastIndexOf(buf, n, value);
+        case SimdLevel::AVX2: return simdAvx2LastIndexOf(buf, n, value);
+        case SimdLevel::SSE2: return simdSse2LastIndexOf(buf, n, value);
+        case SimdLevel::SCALAR: break;
+    }
+#endif
+
+    size_t i = n;
+
+    while (i --> 0)
+    {
+        if (buf[i] == value) return i;
+    }
+
+    return -1;
+}
+// @}
+
+/**
+ * The simdIndexOf and simdLastIndexOf implementations for searchable and other types.
+ */
+// @{
+template <class T> ssize_t simdIndexOf(const T *buf, size_t n, const T &value, std::true_type)
+{
+    typedef typename SimdLane<T>::Type Lane;
+    Lane lane;
+
+    memcpy(&lane, &value, sizeof(lane));
+
+    return simdLaneIndexOf(reinterpret_cast<const Lane*>(buf), n, lane);
+}
+
+template <class T> ssize_t simdIndexOf(const T *buf, size_t n, const T &value, std::false_type)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (buf[i] == value) return i;
+    }
+
+    return -1;
+}
+
+template <class T> ssize_t simdLastIndexOf(const T *buf, size_t n, const T &value, std::true_type)
+{
+    typedef typename SimdLane<T>::Type Lane;
+    Lane lane;
+
+    memcpy(&lane, &value, sizeof(lane));
+
+    return simdLaneLastIndexOf(reinterpret_cast<const Lane*>(buf), n, lane);
+}
+
+template <class T> ssize_t simdLastIndexOf(const T *buf, size_t n, const T &value, std::false_type)
+{
+    size_t i = n;
+
+    while (i --> 0)
+    {
+        if (buf[i] == value) return i;
+    }
+
+    return -1;
+}
+// @}
+
+/**
+ * Finds the first element equal to the value.
+ *
+ * @param[in] buf The elements.
+ * @param[in] n The number of elements.
+ * @param[in] value The value to find.
+ * @returns The index of the first match, -1 if there is none.
+ *
+ * @remarks
+ *  Uses the vector kernels if T is searchable (see SimdSearchable), operator== otherwise.
+ */
+template <class T> ssize_t simdIndexOf(const T *buf, size_t n, const T &value)
+{
+    return simdIndexOf(buf, n, value, SimdSearchable<T>());
+}
+
+/**
+ * Finds the last element equal to the value.
+ *
+ * @param[in] buf The elements.
+ * @param[in] n The number of elements.
+ * @param[in] value The value to find.
+ * @returns The index of the last match, -1 if there is none.
+ *
+ * @remarks
+ *  Uses the vector kernels if T is searchable (see SimdSearchable), operator== otherwise.
+ */
+template <class T> ssize_t simdLastIndexOf(const T *buf, size_t n, const T &value)
+{
+    return simdLastIndexOf(buf, n, value, SimdSearchable<T>());
+}
+
+#endif
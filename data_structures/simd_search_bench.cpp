@@ -0,0 +1,59 @@
+#ifdef BENCHMARK
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "benchmark.h"
+#include "simd_search.h"
+
+static const char *levelNames[] = {"scalar", "SSE2", "AVX2", "AVX-512"};
+
+/**
+ * Scans an array for a value that isn't in it, so every search reads the whole array, at each supported level.
+ */
+template <class T> static void benchMiss(const char *typeName, size_t count, size_t totalElements)
+{
+    T *buf = (T*)malloc(count * sizeof(T));
+
+    for (size_t i = 0; i < count; i++) buf[i] = (T)(i % 1000);
+
+    size_t repeats = totalElements / count;
+    SimdLevel detected = simdDetectLevel();
+
+    for (int level = (int)SimdLevel::SCALAR; level <= (int)detected; level++)
+    {
+        char name[64];
+
+        simdSetLevel((SimdLevel)level);
+        snprintf(name, sizeof(name), "indexOf miss, %s x %zu, %s", typeName, count, levelNames[level]);
+
+        double start = benchNow();
+        for (size_t r = 0; r < repeats; r++)
+        {
+            T needle = (T)(1000 + (r & 1));
+            ssize_t found = simdIndexOf(buf, count, needle);
+
+            benchKeep(found);
+        }
+        benchReport(name, benchNow() - start, repeats * count);
+    }
+
+    simdSetLevel(detected);
+    free(buf);
+}
+
+int main(int argc, char **argv)
+{
+    size_t total = argc > 1 ? strtoull(argv[1], nullptr, 10) : 400000000;
+
+    benchMiss<int32_t>("int32", 100000, total);
+    benchMiss<int32_t>("int32", 10000000, total);
+    benchMiss<uint64_t>("uint64", 100000, total / 2);
+    benchMiss<uint64_t>("uint64", 10000000, total / 2);
+    benchMiss<float>("float", 100000, total);
+    benchMiss<float>("float", 10000000, total);
+
+    return 0;
+}
+
+#endif
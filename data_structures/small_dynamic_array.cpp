@@ -0,0 +1,151 @@
+#ifdef UNIT_TEST
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+
+#include "small_dynamic_array.h"
+
+template <class T>
+struct Alloc
+{
+    static int allocations;
+
+    T *allocate(size_t n) {allocations++; return (T*)malloc(n * sizeof(T));}
+    T *reallocate(T* buf, size_t n) {if (!buf) allocations++; return (T*)realloc(buf, n * sizeof(T)); }
+    void deallocate(T *buf) {free(buf);}
+};
+
+template <class T> int Alloc<T>::allocations = 0;
+
+/** Non-trivial element type that tracks the number of live instances. */
+struct Counted
+{
+    static int live;
+    int *value;
+
+    Counted(int x) : value(new int(x)) {live++;}
+    Counted(const Counted &other) : value(new int(*other.value)) {live++;}
+    Counted(Counted &&other) : value(other.value) {other.value = nullptr; live++;}
+    ~Counted() {delete value; live--;}
+};
+
+int Counted::live = 0;
+
+template <class T, class A> static bool isInside(const T *p, const A &object)
+{
+    const char *c = reinterpret_cast<const char*>(p);
+    const char *o = reinterpret_cast<const char*>(&object);
+
+    return (c >= o) && (c < o + sizeof(object));
+}
+
+int main()
+{
+    {
+        SmallDynArray<int, 16, Alloc<int>> arr;
+
+        for (int i = 0; i < 16; i++)
+        {
+            assert(!arr.add(i));
+        }
+        assert(Alloc<int>::allocations == 0);
+        assert(arr.getCapacity() == 16);
+        assert(isInside(arr.begin(), arr));
+
+        assert(arr.indexOf(5) == 5);
+        assert(arr.contains(15));
+        assert(arr.binarySearch(7));
+        assert(!arr.binarySearch(17));
+        assert(*arr.find([](int x){return x > 3;}) == 4);
+        assert(arr.findIndex([](int x){return x == 9;}) == 9);
+        int sum = 0;
+        arr.forEach([&sum](int &x){sum += x;});
+        assert(sum == 120);
+
+        SmallDynArray<int, 16, Alloc<int>> range = arr.getRange(2, 4);
+        assert(range.getCount() == 4);
+        assert(range[0] == 2);
+        assert(isInside(range.begin(), range));
+
+        SmallDynArray<int, 16, Alloc<int>> even = arr.findAll([](int x){return x % 2 == 0;});
+        assert(even.getCount() == 8);
+        assert(isInside(even.begin(), even));
+        assert(Alloc<int>::allocations == 0);
+
+        // Inline moves move the elements.
+        SmallDynArray<int, 16, Alloc<int>> moved = static_cast<SmallDynArray<int, 16, Alloc<int>>&&>(arr);
+        assert(arr.getCount() == 0);
+        assert(moved.getCount() == 16);
+        assert(isInside(moved.begin(), moved));
+        assert(moved[15] == 15);
+        assert(!arr.add(1)); // The source is usable again.
+        assert(isInside(arr.begin(), arr));
+
+        // Spill to the heap.
+        assert(!moved.add(16));
+        assert(Alloc<int>::allocations == 1);
+        assert(!isInside(moved.begin(), moved));
+        assert(moved.getCapacity() == 32);
+        for (int i = 0; i <= 16; i++) assert(moved[i] == i);
+
+        // Heap moves hand over the buffer.
+        int *heapBuf = moved.begin();
+        SmallDynArray<int, 16, Alloc<int>> movedAgain = static_cast<SmallDynArray<int, 16, Alloc<int>>&&>(moved);
+        assert(movedAgain.begin() == heapBuf);
+        assert(Alloc<int>::allocations == 1);
+
+        // Copies are inline if they fit.
+        SmallDynArray<int, 16, Alloc<int>> copy = even;
+        assert(isInside(copy.begin(), copy));
+        copy = movedAgain;
+        assert(copy.getCount() == 17);
+        assert(!isInside(copy.begin(), copy));
+
+        // Shrinking brings the elements back inline.
+        copy.clear();
+        assert(!copy.add(42));
+        assert(!copy.setCapacity(4));
+        assert(isInside(copy.begin(), copy));
+        assert(copy[0] == 42);
+    }
+
+    {
+        SmallDynArray<int, 4, Alloc<int>> tiny;
+
+        for (int i = 0; i < 4; i++) assert(!tiny.add(i));
+        assert(tiny.getCapacity() == 4);
+        assert(isInside(tiny.begin(), tiny));
+        assert(!tiny.add(4));
+        assert(tiny.getCapacity() == 8);
+    }
+
+    {
+        SmallDynArray<Counted, 8, Alloc<Counted>> counted;
+
+        for (int i = 0; i < 8; i++) assert(!counted.add(Counted(i)));
+        assert(Counted::live == 8);
+
+        SmallDynArray<Counted, 8, Alloc<Counted>> moved = static_cast<SmallDynArray<Counted, 8, Alloc<Counted>>&&>(counted);
+        assert(Counted::live == 8);
+        assert(*moved[7].value == 7);
+
+        for (int i = 8; i < 20; i++) assert(!moved.add(Counted(i)));
+        assert(Counted::live == 20);
+        assert(*moved[0].value == 0);
+        assert(*moved[19].value == 19);
+
+        moved.clear();
+        assert(Counted::live == 0);
+        assert(!moved.add(Counted(1)));
+        assert(!moved.setCapacity(1));
+        assert(isInside(moved.begin(), moved));
+        assert(*moved[0].value == 1);
+    }
+    assert(Counted::live == 0);
+
+    printf("Passed: %s %s\n", __DATE__, __TIME__);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,145 @@
+#ifndef SMALL_DYNAMIC_ARRAY_H
+#define SMALL_DYNAMIC_ARRAY_H
+
+#include <stddef.h>
+#include <string.h>
+
+#include <type_traits>
+
+#include "dynamic_array.h"
+
+/**
+ * Allocator that serves the first buffer of up to N elements from storage inside itself.
+ *
+ * Larger buffers come from the fallback allocator. Copying the allocator copies the fallback only, the inline
+ * storage always belongs to the object it's in.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of elements stored inline.
+ * @tparam Alloc The fallback allocator.
+ */
+template <class T, size_t N, class Alloc>
+struct DynArrayInlineAlloc
+{
+    static_assert(N > 0, "Need at least one inline element.");
+
+    Alloc fallback; ///< Used for buffers larger than N.
+
+    DynArrayInlineAlloc(const Alloc &fallback = Alloc()) : fallback(fallback) {}
+    DynArrayInlineAlloc(const DynArrayInlineAlloc &other) : fallback(other.fallback) {}
+
+    DynArrayInlineAlloc& operator=(const DynArrayInlineAlloc &other)
+    {
+        fallback = other.fallback;
+        return *this;
+    }
+
+    T *allocate(size_t n)
+    {
+        if ((n <= N) && !inlineUsed)
+        {
+            inlineUsed = true;
+            return inlineBuf();
+        }
+
+        return fallback.allocate(n);
+    }
+
+    T *reallocate(T *buf, size_t n)
+    {
+        if (!buf) return allocate(n);
+
+        if (isInline(buf))
+        {
+            if (n <= N) return buf;
+
+            T *newBuf = fallback.allocate(n);
+            if (!newBuf) return nullptr;
+
+            memcpy(static_cast<void*>(newBuf), static_cast<void*>(buf), N * sizeof(T));
+            inlineUsed = false;
+
+            return newBuf;
+        }
+
+        if ((n <= N) && !inlineUsed)
+        {
+            // Shrunk enough to come back inline.
+            memcpy(static_cast<void*>(inlineBuf()), static_cast<void*>(buf), n * sizeof(T));
+            fallback.deallocate(buf);
+            inlineUsed = true;
+
+            return inlineBuf();
+        }
+
+        return fallback.reallocate(buf, n);
+    }
+
+    bool tryExpand(T *buf, size_t oldN, size_t newN)
+    {
+        if (isInline(buf)) return newN <= N;
+
+        return DynArrayAllocTraits<T, Alloc>::tryExpand(fallback, buf, oldN, newN);
+    }
+
+    size_t usableSize(T *buf)
+    {
+        if (isInline(buf)) return N;
+
+        return DynArrayAllocTraits<T, Alloc>::usableSize(fallback, buf, 0);
+    }
+
+    void deallocate(T *buf)
+    {
+        if (isInline(buf))
+        {
+            inlineUsed = false;
+        }
+        else
+        {
+            fallback.deallocate(buf);
+        }
+    }
+
+    bool isInline(const T *buf) const {return buf == inlineBuf();}
+
+private:
+    bool inlineUsed = false; ///< True if the inline storage is handed out.
+    typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type storage; ///< The inline elements.
+
+    T *inlineBuf() {return reinterpret_cast<T*>(&storage);}
+    const T *inlineBuf() const {return reinterpret_cast<const T*>(&storage);}
+};
+
+/**
+ * Growth policy for arrays with inline storage: jumps straight to N elements, then continues with the base policy.
+ *
+ * @tparam N The number of inline elements.
+ * @tparam BasePolicy The policy used beyond N.
+ */
+template <size_t N, class BasePolicy = DynArrayDoublingGrowth>
+struct DynArrayInlineGrowth
+{
+    static size_t grow(size_t capacity, size_t required, size_t elemSize)
+    {
+        if (required <= N) return N;
+
+        return BasePolicy::grow(capacity < N ? N : capacity, required, elemSize);
+    }
+};
+
+/**
+ * Dynamic array that keeps its first N elements inside the object and only allocates when it grows beyond that.
+ *
+ * It's a DynArray, so it has the same API. Moving an array whose elements are inline moves the elements, moving
+ * one that spilled to the heap hands over the buffer.
+ *
+ * @tparam T The type of elements.
+ * @tparam N The number of elements stored inline.
+ * @tparam Alloc The allocator used once the array outgrows the inline storage.
+ * @tparam GrowthPolicy Decides the new capacity beyond N.
+ */
+template <class T, size_t N, class Alloc, class GrowthPolicy = DynArrayDoublingGrowth>
+using SmallDynArray = DynArray<T, DynArrayInlineAlloc<T, N, Alloc>, DynArrayInlineGrowth<N, GrowthPolicy>>;
+
+#endif
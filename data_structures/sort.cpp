@@ -0,0 +1,267 @@
+#ifdef UNIT_TEST
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "sort.h"
+
+/** Three way comparator using the < operator, counting the calls. */
+struct Less
+{
+    static size_t calls;
+
+    template <class T> int operator()(const T &a, const T &b) const
+    {
+        calls++;
+        return (b < a) - (a < b);
+    }
+};
+
+size_t Less::calls = 0;
+
+/** Element with a key to sort by and its original position, to check stability. */
+struct Keyed
+{
+    int key;
+    int index;
+};
+
+/** Compares the keys of Keyed elements only. */
+struct ByKey
+{
+    int operator()(const Keyed &a, const Keyed &b) const {return (a.key > b.key) - (a.key < b.key);}
+};
+
+/** Non-trivial element that tracks the number of live instances and is sorted with the classic partitioning. */
+struct Boxed
+{
+    static int live;
+    int *value;
+
+    Boxed(int x) : value(new int(x)) {live++;}
+    Boxed(const Boxed &other) : value(new int(*other.value)) {live++;}
+    Boxed(Boxed &&other) : value(other.value) {other.value = nullptr; live++;}
+    ~Boxed() {delete value; live--;}
+
+    Boxed& operator=(const Boxed &other) {*value = *other.value; return *this;}
+    Boxed& operator=(Boxed &&other) {std::swap(value, other.value); return *this;}
+};
+
+int Boxed::live = 0;
+
+struct ByValue
+{
+    int operator()(const Boxed &a, const Boxed &b) const {return (*a.value > *b.value) - (*a.value < *b.value);}
+};
+
+static uint32_t state = 1;
+
+static uint32_t next()
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+
+    return state;
+}
+
+/**
+ * Fills the array with one of the inputs quicksort implementations have trouble with.
+ */
+static void generate(int *values, size_t n, int pattern)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        switch (pattern)
+        {
+            case 0: values[i] = (int)next(); break; // Random.
+            case 1: values[i] = (int)i; break; // Sorted.
+            case 2: values[i] = (int)(n - i); break; // Reversed.
+            case 3: values[i] = 42; break; // All equal.
+            case 4: values[i] = next() % 4; break; // Few distinct.
+            case 5: values[i] = (int)(i < n / 2 ? i : n - i); break; // Organ pipe.
+            case 6: values[i] = (int)(i % 32); break; // Sawtooth.
+            case 7: values[i] = (int)(i ^ 1); break; // Pairs swapped.
+            case 8: values[i] = (int)(i + (next() % 64 == 0 ? n : 0)); break; // Sorted with a few large ones.
+            default: values[i] = (int)((i * 2 < n ? 2 * i : 2 * (n - i) - 1)); break; // Interleaved.
+        }
+    }
+}
+
+template <class T> static bool isSorted(const T *values, size_t n)
+{
+    for (size_t i = 1; i < n; i++) if (values[i] < values[i - 1]) return false;
+
+    return true;
+}
+
+int main()
+{
+    {
+        // Every permutation of the network sizes and every 0-1 input, which proves a network sorts everything.
+        int values[sortNetworkMax];
+        int perm[sortNetworkMax];
+
+        for (size_t n = 0; n <= sortNetworkMax; n++)
+        {
+            for (size_t i = 0; i < n; i++) perm[i] = (int)i;
+
+            do
+            {
+                std::copy(perm, perm + n, values);
+                sortNetwork(values, n, Less());
+                for (size_t i = 0; i < n; i++) assert(values[i] == (int)i);
+            }
+            while (std::next_permutation(perm, perm + n));
+
+            for (uint32_t bits = 0; bits < (1u << n); bits++)
+            {
+                for (size_t i = 0; i < n; i++) values[i] = (bits >> i) & 1;
+                sortNetwork(values, n, Less());
+                assert(isSorted(values, n));
+            }
+        }
+    }
+
+    {
+        // Against std::sort, for every pattern at sizes around the thresholds and large enough to use the ninther.
+        static const size_t sizes[] = {0, 1, 2, 3, 7, 8, 9, 23, 24, 25, 63, 64, 65, 127, 128, 129, 200, 1000, 4096,
+            100000};
+        std::vector<int> input;
+        std::vector<int> values;
+        std::vector<int> expected;
+
+        for (size_t n : sizes)
+        {
+            for (int pattern = 0; pattern < 10; pattern++)
+            {
+                input.resize(n);
+                generate(input.data(), n, pattern);
+                expected = input;
+                std::sort(expected.begin(), expected.end());
+
+                values = input;
+                Less::calls = 0;
+                sortUnstable(values.data(), n, Less());
+                assert(values == expected);
+
+                // Sorted and equal inputs take a linear number of comparisons.
+                if ((pattern == 1) || (pattern == 3)) assert(Less::calls <= 4 * n);
+
+                values = input;
+                sortStable(values.data(), n, Less(), (int*)nullptr);
+                assert(values == expected);
+
+                std::vector<int> scratch(sortStableScratchSize(n));
+                values = input;
+                sortStable(values.data(), n, Less(), scratch.data());
+                assert(values == expected);
+            }
+        }
+    }
+
+    {
+        // Heapsort, the worst case fallback.
+        std::vector<int> values(5000);
+
+        for (size_t i = 0; i < values.size(); i++) values[i] = (int)(next() % 1000);
+        sortHeap(values.data(), values.data() + values.size(), Less());
+        assert(isSorted(values.data(), values.size()));
+
+        // Equal elements all go to the right of the first partition, which is bad, so with one bad partition allowed
+        // the loop falls back to heapsort right away.
+        for (size_t i = 0; i < 300; i++) values[i] = 7;
+        values[150] = 3;
+        values[299] = 9;
+        Less::calls = 0;
+        sortPdq(values.data(), values.data() + 300, Less(), 1, true);
+        assert(isSorted(values.data(), 300));
+        assert((values[0] == 3) && (values[299] == 9));
+        assert(Less::calls > 300 * 4); // Heapsort doesn't see that it's nearly all equal.
+    }
+
+    {
+        // Floating point and unsigned keys, partitioned in blocks.
+        std::vector<double> doubles(3000);
+        std::vector<uint8_t> bytes(3000);
+
+        for (size_t i = 0; i < doubles.size(); i++)
+        {
+            doubles[i] = (double)(int)next() / 7.0;
+            bytes[i] = (uint8_t)next();
+        }
+
+        sortUnstable(doubles.data(), doubles.size(), Less());
+        sortUnstable(bytes.data(), bytes.size(), Less());
+        assert(isSorted(doubles.data(), doubles.size()));
+        assert(isSorted(bytes.data(), bytes.size()));
+    }
+
+    {
+        // Equal keys keep their order in the stable sort, with and without scratch space.
+        for (size_t n : {17, 100, 1000, 20000})
+        {
+            std::vector<Keyed> values(n);
+            std::vector<Keyed> scratch(sortStableScratchSize(n));
+
+            for (int withScratch = 0; withScratch < 2; withScratch++)
+            {
+                for (size_t i = 0; i < n; i++) values[i] = {(int)(next() % 10), (int)i};
+
+                sortStable(values.data(), n, ByKey(), withScratch ? scratch.data() : nullptr);
+
+                for (size_t i = 1; i < n; i++)
+                {
+                    assert(values[i - 1].key <= values[i].key);
+                    if (values[i - 1].key == values[i].key) assert(values[i - 1].index < values[i].index);
+                }
+            }
+        }
+    }
+
+    {
+        // Non-trivial elements are moved, not leaked or duplicated.
+        std::vector<Boxed> values;
+        int total = 0;
+
+        for (int i = 0; i < 2000; i++)
+        {
+            values.push_back(Boxed((int)(next() % 500)));
+            total += *values.back().value;
+        }
+
+        for (int round = 0; round < 3; round++)
+        {
+            Boxed *scratch = (Boxed*)malloc(sortStableScratchSize(values.size()) * sizeof(Boxed));
+
+            if (round == 0) sortUnstable(values.data(), values.size(), ByValue());
+            if (round == 1) sortStable(values.data(), values.size(), ByValue(), scratch);
+            if (round == 2) sortStable(values.data(), values.size(), ByValue(), (Boxed*)nullptr);
+            free(scratch);
+
+            int sum = 0;
+
+            for (size_t i = 0; i < values.size(); i++)
+            {
+                sum += *values[i].value;
+                if (i > 0) assert(*values[i - 1].value <= *values[i].value);
+            }
+
+            assert(sum == total);
+            assert(Boxed::live == 2000);
+            std::reverse(values.begin(), values.end());
+        }
+    }
+
+    assert(Boxed::live == 0);
+
+    printf("Passed: %s %s\n", __DATE__, __TIME__);
+
+    return 0;
+}
+
+#endif
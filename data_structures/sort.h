@@ -0,0 +1,682 @@
+#ifndef SORT_H
+#define SORT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <new>
+#include <type_traits>
+
+/**
+ * In-place sorting of arrays with three way comparators.
+ *
+ * The comparators are the same as the ones DynArray::binarySearch takes: a functor with the signature
+ * int compare(const T &a, const T &b), which returns negative if a < b, positive if a > b, zero if a == b.
+ *
+ * sortUnstable is pattern-defeating quicksort (pdqsort, Orson Peters): quicksort with median of three or ninther
+ * pivots, which recognizes sorted runs and many equal elements and gets linear on them, shuffles the array when the
+ * partitions get unbalanced and falls back to heapsort after too many of those, so it's O(n log n) in the worst
+ * case. It never allocates.
+ *
+ * sortStable is a merge sort, which merges through a scratch buffer if given one, or with rotations in place if not.
+ *
+ *   sortUnstable(values, count, DynArrayCompare<int>());
+ */
+
+/**
+ * Tells whether elements of type T are sorted without branching on the comparisons.
+ *
+ * Such elements are compare-exchanged with conditional moves in the small sorting networks and are partitioned in
+ * blocks: the comparisons of a block are done first, recording the positions of the misplaced elements, then those
+ * are swapped. There are no mispredicted branches then, which dominate the time of sorting cheap elements.
+ *
+ * @remarks
+ *  Defaults to trivially copyable types up to 16 bytes.
+ */
+template <class T>
+struct SortBranchless : std::integral_constant<bool, std::is_trivially_copyable<T>::value && (sizeof(T) <= 16)> {};
+
+static const size_t sortNetworkMax = 8; ///< Ranges up to this size are sorted by sorting networks.
+static const size_t sortInsertionMax = 24; ///< Ranges below this size are sorted by insertion sort.
+static const size_t sortNintherMin = 128; ///< Ranges above this size take the pivot as the median of medians.
+static const size_t sortPartialInsertionLimit = 8; ///< Moves allowed when trying to finish a partition by insertion.
+static const size_t sortBlockSize = 64; ///< The number of elements compared at once by the block partitioning.
+static const size_t sortStableRun = 16; ///< Ranges up to this size are sorted by insertion in the stable sort.
+
+/**
+ * Puts the two elements into order.
+ */
+// @{
+template <class T, class Compare> void sortPair(T &a, T &b, const Compare &c, std::true_type)
+{
+    bool swap = c(b, a) < 0;
+    T low = swap ? b : a;
+    T high = swap ? a : b;
+
+    a = low;
+    b = high;
+}
+
+template <class T, class Compare> void sortPair(T &a, T &b, const Compare &c, std::false_type)
+{
+    if (c(b, a) < 0) std::swap(a, b);
+}
+
+template <class T, class Compare> void sortPair(T &a, T &b, const Compare &c)
+{
+    sortPair(a, b, c, SortBranchless<T>());
+}
+// @}
+
+/**
+ * Puts the three elements into order.
+ */
+template <class T, class Compare> void sortThree(T &a, T &b, T &d, const Compare &c)
+{
+    sortPair(a, b, c);
+    sortPair(b, d, c);
+    sortPair(a, b, c);
+}
+
+/**
+ * Sorts up to sortNetworkMax elements with the smallest known sorting networks. The compare-exchanges of a network
+ * don't depend on each other's results, so they have no branches to mispredict.
+ */
+template <class T, class Compare> void sortNetwork(T *v, size_t n, const Compare &c)
+{
+    auto cx = [v, &c](size_t i, size_t j) {sortPair(v[i], v[j], c);};
+
+    switch (n)
+    {
+        case 2:
+            cx(0, 1);
+            break;
+        case 3:
+            cx(0, 2); cx(0, 1); cx(1, 2);
+            break;
+        case 4:
+            cx(0, 2); cx(1, 3); cx(0, 1); cx(2, 3); cx(1, 2);
+            break;
+        case 5:
+            cx(0, 3); cx(1, 4); cx(0, 2); cx(1, 3); cx(0, 1); cx(2, 4); cx(1, 2); cx(3, 4); cx(2, 3);
+            break;
+        case 6:
+            cx(0, 5); cx(1, 3); cx(2, 4); cx(1, 2); cx(3, 4); cx(0, 3); cx(2, 5); cx(0, 1); cx(2, 3); cx(4, 5);
+            cx(1, 2); cx(3, 4);
+            break;
+        case 7:
+            cx(0, 6); cx(2, 3); cx(4, 5); cx(0, 2); cx(1, 4); cx(3, 6); cx(0, 1); cx(2, 5); cx(3, 4); cx(1, 2);
+            cx(4, 6); cx(2, 3); cx(4, 5); cx(1, 2); cx(3, 4); cx(5, 6);
+            break;
+        case 8:
+            cx(0, 2); cx(1, 3); cx(4, 6); cx(5, 7); cx(0, 4); cx(1, 5); cx(2, 6); cx(3, 7); cx(0, 1); cx(2, 3);
+            cx(4, 5); cx(6, 7); cx(2, 4); cx(3, 5); cx(1, 4); cx(3, 6); cx(1, 2); cx(3, 4); cx(5, 6);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * Insertion sort. Stable.
+ *
+ * @tparam Guarded False if there is an element before begin that is not greater than any element of the range, so
+ *      the inner loop doesn't need to check for reaching the start.
+ */
+template <bool Guarded, class T, class Compare> void sortInsertion(T *begin, T *end, const Compare &c)
+{
+    if (begin == end) return;
+
+    for (T *cur = begin + 1; cur < end; cur++)
+    {
+        if (!(c(*cur, cur[-1]) < 0)) continue;
+
+        T tmp(static_cast<T&&>(*cur));
+        T *sift = cur;
+
+        do
+        {
+            *sift = static_cast<T&&>(sift[-1]);
+            sift--;
+        }
+        while ((!Guarded || (sift != begin)) && (c(tmp, sift[-1]) < 0));
+
+        *sift = static_cast<T&&>(tmp);
+    }
+}
+
+/**
+ * Attempts insertion sort, but gives up after moving sortPartialInsertionLimit elements.
+ *
+ * @returns True if the range got sorted.
+ */
+template <class T, class Compare> bool sortPartialInsertion(T *begin, T *end, const Compare &c)
+{
+    size_t moves = 0;
+
+    if (begin == end) return true;
+
+    for (T *cur = begin + 1; cur < end; cur++)
+    {
+        if (!(c(*cur, cur[-1]) < 0)) continue;
+
+        T tmp(static_cast<T&&>(*cur));
+        T *sift = cur;
+
+        do
+        {
+            *sift = static_cast<T&&>(sift[-1]);
+            sift--;
+        }
+        while ((sift != begin) && (c(tmp, sift[-1]) < 0));
+
+        *sift = static_cast<T&&>(tmp);
+        moves += cur - sift;
+
+        if (moves > sortPartialInsertionLimit) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Heapsort, the fallback that bounds the quicksort to O(n log n).
+ */
+template <class T, class Compare> void sortHeap(T *begin, T *end, const Compare &c)
+{
+    auto less = [&c](const T &a, const T &b) {return c(a, b) < 0;};
+
+    std::make_heap(begin, end, less);
+    std::sort_heap(begin, end, less);
+}
+
+/**
+ * Partitions the range around its first element, the elements equal to it go to the left.
+ *
+ * Used when the pivot equals the element before the range, which is not greater than anything in it: no element can
+ * be less than the pivot then, so after this the left part is all equal and needs no more sorting.
+ *
+ * @returns The new position of the pivot.
+ */
+template <class T, class Compare> T *sortPartitionLeft(T *begin, T *end, const Compare &c)
+{
+    T pivot(static_cast<T&&>(*begin));
+    T *first = begin;
+    T *last = end;
+
+    while (c(pivot, *--last) < 0);
+
+    if (last + 1 == end)
+    {
+        while ((first < last) && !(c(pivot, *++first) < 0));
+    }
+    else
+    {
+        // The greater element found on the right stops the scan.
+        while (!(c(pivot, *++first) < 0));
+    }
+
+    while (first < last)
+    {
+        std::swap(*first, *last);
+        while (c(pivot, *--last) < 0);
+        while (!(c(pivot, *++first) < 0));
+    }
+
+    *begin = static_cast<T&&>(*last);
+    *last = static_cast<T&&>(pivot);
+
+    return last;
+}
+
+/**
+ * Partitions the range around its first element, the elements equal to it go to the right.
+ *
+ * The range must have an element not less than the pivot after it (or be the end of a median of three) so the scans
+ * stop without bounds checks.
+ *
+ * @param[out] alreadyPartitioned Receives true if no elements had to be swapped.
+ * @returns The new position of the pivot.
+ */
+// @{
+template <class T, class Compare> T *sortPartitionRight(T *begin, T *end, const Compare &c, bool &alreadyPartitioned,
+    std::false_type)
+{
+    T pivot(static_cast<T&&>(*begin));
+    T *first = begin;
+    T *last = end;
+
+    while (c(*++first, pivot) < 0);
+
+    if (first - 1 == begin)
+    {
+        while ((first < last) && !(c(*--last, pivot) < 0));
+    }
+    else
+    {
+        while (!(c(*--last, pivot) < 0));
+    }
+
+    alreadyPartitioned = first >= last;
+
+    while (first < last)
+    {
+        std::swap(*first, *last);
+        while (c(*++first, pivot) < 0);
+        while (!(c(*--last, pivot) < 0));
+    }
+
+    T *pivotPos = first - 1;
+
+    *begin = static_cast<T&&>(*pivotPos);
+    *pivotPos = static_cast<T&&>(pivot);
+
+    return pivotPos;
+}
+
+template <class T, class Compare> T *sortPartitionRight(T *begin, T *end, const Compare &c, bool &alreadyPartitioned,
+    std::true_type)
+{
+    T pivot(static_cast<T&&>(*begin));
+    T *first = begin;
+    T *last = end;
+
+    while (c(*++first, pivot) < 0);
+
+    if (first - 1 == begin)
+    {
+        while ((first < last) && !(c(*--last, pivot) < 0));
+    }
+    else
+    {
+        while (!(c(*--last, pivot) < 0));
+    }
+
+    alreadyPartitioned = first >= last;
+
+    if (!alreadyPartitioned)
+    {
+        std::swap(*first, *last);
+        first++;
+
+        // Block partitioning (BlockQuicksort, Edelkamp and Weiss). The offsets of the elements on the wrong side are
+        // collected from a block at each end with the comparison results added to the counts instead of branched on,
+        // then the misplaced elements are swapped in pairs.
+        alignas(64) unsigned char offsetsL[sortBlockSize];
+        alignas(64) unsigned char offsetsR[sortBlockSize];
+        T *baseL = first;
+        T *baseR = last;
+        size_t countL = 0;
+        size_t countR = 0;
+        size_t startL = 0;
+        size_t startR = 0;
+
+        while (first < last)
+        {
+            // Only refill the blocks that are empty, split the unknown elements between them.
+            size_t unknown = last - first;
+            size_t splitL = countL == 0 ? (countR == 0 ? unknown / 2 : unknown) : 0;
+            size_t splitR = countR == 0 ? unknown - splitL : 0;
+
+            if (splitL > sortBlockSize) splitL = sortBlockSize;
+            if (splitR > sortBlockSize) splitR = sortBlockSize;
+
+            for (size_t i = 0; i < splitL; i++)
+            {
+                offsetsL[countL] = (unsigned char)i;
+                countL += !(c(*first, pivot) < 0);
+                first++;
+            }
+
+            for (size_t i = 0; i < splitR; i++)
+            {
+                offsetsR[countR] = (unsigned char)(i + 1);
+                countR += c(*--last, pivot) < 0;
+            }
+
+            size_t count = countL < countR ? countL : countR;
+            unsigned char *l = offsetsL + startL;
+            unsigned char *r = offsetsR + startR;
+
+            if (countL == countR)
+            {
+                // Plain swaps keep descending inputs linear.
+                for (size_t i = 0; i < count; i++) std::swap(baseL[l[i]], baseR[-(ptrdiff_t)r[i]]);
+            }
+            else if (count > 0)
+            {
+                // A cyclic permutation moves each element once instead of three times for a swap.
+                T *left = baseL + l[0];
+                T *right = baseR - r[0];
+                T tmp(static_cast<T&&>(*left));
+
+                *left = static_cast<T&&>(*right);
+                for (size_t i = 1; i < count; i++)
+                {
+                    left = baseL + l[i];
+                    *right = static_cast<T&&>(*left);
+                    right = baseR - r[i];
+                    *left = static_cast<T&&>(*right);
+                }
+                *right = static_cast<T&&>(tmp);
+            }
+
+            countL -= count;
+            countR -= count;
+            startL += count;
+            startR += count;
+
+            if (countL == 0)
+            {
+                startL = 0;
+                baseL = first;
+            }
+
+            if (countR == 0)
+            {
+                startR = 0;
+                baseR = last;
+            }
+        }
+
+        // One of the blocks may still hold misplaced elements, move them to the boundary.
+        if (countL)
+        {
+            unsigned char *l = offsetsL + startL;
+
+            while (countL--) std::swap(baseL[l[countL]], *--last);
+            first = last;
+        }
+
+        if (countR)
+        {
+            unsigned char *r = offsetsR + startR;
+
+            while (countR--) std::swap(baseR[-(ptrdiff_t)r[countR]], *first++);
+        }
+    }
+
+    T *pivotPos = first - 1;
+
+    *begin = static_cast<T&&>(*pivotPos);
+    *pivotPos = static_cast<T&&>(pivot);
+
+    return pivotPos;
+}
+// @}
+
+/**
+ * The pdqsort loop, recursing into the left partition and iterating on the right one.
+ *
+ * @param[in] badAllowed The number of unbalanced partitions left before falling back to heapsort.
+ * @param[in] leftmost False if the element before begin is not greater than any element in the range.
+ */
+template <class T, class Compare> void sortPdq(T *begin, T *end, const Compare &c, int badAllowed, bool leftmost)
+{
+    while (true)
+    {
+        size_t size = end - begin;
+
+        if (size <= sortNetworkMax)
+        {
+            sortNetwork(begin, size, c);
+            return;
+        }
+
+        if (size < sortInsertionMax)
+        {
+            if (leftmost)
+            {
+                sortInsertion<true>(begin, end, c);
+            }
+            else
+            {
+                sortInsertion<false>(begin, end, c);
+            }
+
+            return;
+        }
+
+        // Move the pivot to the start, the samples around it end up on the sides they belong to and stop the scans.
+        size_t half = size / 2;
+
+        if (size > sortNintherMin)
+        {
+            sortThree(begin[0], begin[half], end[-1], c);
+            sortThree(begin[1], begin[half - 1], end[-2], c);
+            sortThree(begin[2], begin[half + 1], end[-3], c);
+            sortThree(begin[half - 1], begin[half], begin[half + 1], c);
+            std::swap(begin[0], begin[half]);
+        }
+        else
+        {
+            sortThree(begin[half], begin[0], end[-1], c);
+        }
+
+        // The pivot equals the element before the range, so all the elements equal to it are done.
+        if (!leftmost && !(c(begin[-1], *begin) < 0))
+        {
+            begin = sortPartitionLeft(begin, end, c) + 1;
+            continue;
+        }
+
+        bool alreadyPartitioned;
+        T *pivotPos = sortPartitionRight(begin, end, c, alreadyPartitioned, SortBranchless<T>());
+        size_t sizeL = pivotPos - begin;
+        size_t sizeR = end - (pivotPos + 1);
+
+        if ((sizeL < size / 8) || (sizeR < size / 8))
+        {
+            if (--badAllowed == 0)
+            {
+                sortHeap(begin, end, c);
+                return;
+            }
+
+            // Break up the pattern that produced the bad pivot.
+            if (sizeL >= sortInsertionMax)
+            {
+                std::swap(begin[0], begin[sizeL / 4]);
+                std::swap(pivotPos[-1], pivotPos[-(ptrdiff_t)(sizeL / 4)]);
+
+                if (sizeL > sortNintherMin)
+                {
+                    std::swap(begin[1], begin[sizeL / 4 + 1]);
+                    std::swap(begin[2], begin[sizeL / 4 + 2]);
+                    std::swap(pivotPos[-2], pivotPos[-(ptrdiff_t)(sizeL / 4 + 1)]);
+                    std::swap(pivotPos[-3], pivotPos[-(ptrdiff_t)(sizeL / 4 + 2)]);
+                }
+            }
+
+            if (sizeR >= sortInsertionMax)
+            {
+                std::swap(pivotPos[1], pivotPos[1 + sizeR / 4]);
+                std::swap(end[-1], end[-(ptrdiff_t)(sizeR / 4)]);
+
+                if (sizeR > sortNintherMin)
+                {
+                    std::swap(pivotPos[2], pivotPos[2 + sizeR / 4]);
+                    std::swap(pivotPos[3], pivotPos[3 + sizeR / 4]);
+                    std::swap(end[-2], end[-(ptrdiff_t)(1 + sizeR / 4)]);
+                    std::swap(end[-3], end[-(ptrdiff_t)(2 + sizeR / 4)]);
+                }
+            }
+        }
+        else if (alreadyPartitioned && sortPartialInsertion(begin, pivotPos, c) &&
+            sortPartialInsertion(pivotPos + 1, end, c))
+        {
+            // Nothing was swapped and both sides are nearly sorted, probably the whole range was.
+            return;
+        }
+
+        sortPdq(begin, pivotPos, c, badAllowed, leftmost);
+        begin = pivotPos + 1;
+        leftmost = false;
+    }
+}
+
+/**
+ * Sorts the array in place with pattern-defeating quicksort. Equal elements may be reordered.
+ *
+ * @param[in,out] buf The elements.
+ * @param[in] n The number of elements.
+ * @param[in] c Three way comparator.
+ */
+template <class T, class Compare> void sortUnstable(T *buf, size_t n, const Compare &c)
+{
+    int badAllowed = 0; // log2(n)
+
+    for (size_t s = n; s > 1; s >>= 1) badAllowed++;
+
+    sortPdq(buf, buf + n, c, badAllowed, true);
+}
+
+/**
+ * Merges two sorted adjacent ranges in place by rotations, O(n log n) moves. Stable.
+ */
+template <class T, class Compare> void sortMergeInPlace(T *first, T *mid, T *last, const Compare &c)
+{
+    auto less = [&c](const T &a, const T &b) {return c(a, b) < 0;};
+
+    while ((first != mid) && (mid != last))
+    {
+        size_t countL = mid - first;
+        size_t countR = last - mid;
+
+        if (countL + countR == 2)
+        {
+            if (c(*mid, *first) < 0) std::swap(*first, *mid);
+            return;
+        }
+
+        // Split the larger side in half, find where its middle goes in the other and swap the parts between.
+        T *cutL;
+        T *cutR;
+
+        if (countL > countR)
+        {
+            cutL = first + countL / 2;
+            cutR = std::lower_bound(mid, last, *cutL, less);
+        }
+        else
+        {
+            cutR = mid + countR / 2;
+            cutL = std::upper_bound(first, mid, *cutR, less);
+        }
+
+        std::rotate(cutL, mid, cutR);
+
+        T *newMid = cutL + (cutR - mid);
+
+        // Recurse into the smaller half.
+        if ((newMid - first) < (last - newMid))
+        {
+            sortMergeInPlace(first, cutL, newMid, c);
+            first = newMid;
+            mid = cutR;
+        }
+        else
+        {
+            sortMergeInPlace(newMid, cutR, last, c);
+            last = newMid;
+            mid = cutL;
+        }
+    }
+}
+
+/**
+ * Merges two sorted adjacent ranges, moving the left one out to the scratch buffer. Stable.
+ *
+ * @param[in] scratch Uninitialized room for mid - first elements.
+ */
+template <class T, class Compare> void sortMergeBuffered(T *first, T *mid, T *last, const Compare &c, T *scratch)
+{
+    size_t countL = mid - first;
+
+    for (size_t i = 0; i < countL; i++) new (scratch + i) T(static_cast<T&&>(first[i]));
+
+    T *l = scratch;
+    T *endL = scratch + countL;
+    T *r = mid;
+    T *out = first;
+
+    while ((l < endL) && (r < last))
+    {
+        if (c(*r, *l) < 0)
+        {
+            *out++ = static_cast<T&&>(*r++);
+        }
+        else
+        {
+            *out++ = static_cast<T&&>(*l++);
+        }
+    }
+
+    while (l < endL) *out++ = static_cast<T&&>(*l++);
+
+    for (size_t i = 0; i < countL; i++) scratch[i].~T();
+}
+
+/**
+ * The merge sort of sortStable.
+ */
+template <class T, class Compare> void sortMerge(T *begin, T *end, const Compare &c, T *scratch)
+{
+    size_t size = end - begin;
+
+    if (size <= sortStableRun)
+    {
+        sortInsertion<true>(begin, end, c);
+        return;
+    }
+
+    // The left half is the smaller one, so n / 2 elements of scratch space are enough for every merge.
+    T *mid = begin + size / 2;
+
+    sortMerge(begin, mid, c, scratch);
+    sortMerge(mid, end, c, scratch);
+
+    if (!(c(*mid, mid[-1]) < 0)) return; // Already in order.
+
+    if (c(end[-1], *begin) < 0)
+    {
+        // The halves are in reverse order, as in a descending input.
+        std::rotate(begin, mid, end);
+        return;
+    }
+
+    if (scratch)
+    {
+        sortMergeBuffered(begin, mid, end, c, scratch);
+    }
+    else
+    {
+        sortMergeInPlace(begin, mid, end, c);
+    }
+}
+
+/**
+ * @returns The number of scratch elements sortStable uses to sort n elements, zero if it doesn't need any.
+ */
+inline size_t sortStableScratchSize(size_t n)
+{
+    return n > sortStableRun ? n / 2 : 0;
+}
+
+/**
+ * Sorts the array in place with merge sort. Equal elements keep their order.
+ *
+ * O(n log n) with the scratch buffer, O(n log^2 n) without it.
+ *
+ * @param[in,out] buf The elements.
+ * @param[in] n The number of elements.
+ * @param[in] c Three way comparator.
+ * @param[in] scratch Uninitialized room for sortStableScratchSize(n) elements, or nullptr to merge in place.
+ */
+template <class T, class Compare> void sortStable(T *buf, size_t n, const Compare &c, T *scratch)
+{
+    sortMerge(buf, buf + n, c, scratch);
+}
+
+#endif
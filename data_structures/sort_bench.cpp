@@ -0,0 +1,116 @@
+#ifdef BENCHMARK
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+
+#include "benchmark.h"
+#include "dynamic_array.h"
+
+template <class T>
+struct Alloc
+{
+    T *allocate(size_t n) {return (T*)malloc(n * sizeof(T));}
+    T *reallocate(T* buf, size_t n) {return (T*)realloc(buf, n * sizeof(T));}
+    void deallocate(T *buf) {free(buf);}
+};
+
+/** Allocator that can only reallocate, so the stable sort gets no scratch buffer and merges in place. */
+template <class T>
+struct ReallocOnlyAlloc
+{
+    T *allocate(size_t) {return nullptr;}
+    T *reallocate(T* buf, size_t n) {return (T*)realloc(buf, n * sizeof(T));}
+    void deallocate(T *buf) {free(buf);}
+};
+
+template <class T> static int compareQsort(const void *a, const void *b)
+{
+    const T &x = *(const T*)a;
+    const T &y = *(const T*)b;
+
+    return (y < x) - (x < y);
+}
+
+static const char *patternNames[] = {"random", "sorted", "reversed", "few distinct", "sorted + 1%"};
+
+/**
+ * Fills the array with the given pattern.
+ */
+template <class T> static void generate(T *values, size_t n, int pattern)
+{
+    uint64_t state = 88172645463325252ull;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+
+        switch (pattern)
+        {
+            case 0: values[i] = (T)state; break;
+            case 1: values[i] = (T)i; break;
+            case 2: values[i] = (T)(n - i); break;
+            case 3: values[i] = (T)(state % 16); break;
+            default: values[i] = (T)(state % 100 == 0 ? state : i); break;
+        }
+    }
+}
+
+/**
+ * Sorts the same input with qsort, std::sort, std::stable_sort and the DynArray sorts, each repeated until it
+ * takes enough time to measure.
+ */
+template <class T> static void benchSort(const char *typeName, size_t count, int pattern)
+{
+    const size_t rounds = (4 * 1024 * 1024 + count - 1) / count;
+    DynArray<T, Alloc<T>> input;
+    DynArray<T, Alloc<T>> values;
+    DynArray<T, ReallocOnlyAlloc<T>> noScratch;
+
+    if (!input.appendUninitialized(count) || !values.appendUninitialized(count)) return;
+    if (!noScratch.appendUninitialized(count)) return;
+    generate(input.begin(), count, pattern);
+
+    char name[64];
+    double elapsed;
+    double start;
+
+#define BENCH_SORT(label, array, stmt) \
+    elapsed = 0; \
+    for (size_t r = 0; r < rounds; r++) \
+    { \
+        input.copyTo(array.begin()); \
+        start = benchNow(); \
+        stmt; \
+        elapsed += benchNow() - start; \
+    } \
+    benchKeep(array[count / 2]); \
+    snprintf(name, sizeof(name), "%s %s %s %zu", label, typeName, patternNames[pattern], count); \
+    benchReport(name, elapsed, rounds * count);
+
+    BENCH_SORT("qsort", values, qsort(values.begin(), count, sizeof(T), compareQsort<T>));
+    BENCH_SORT("std::sort", values, std::sort(values.begin(), values.end()));
+    BENCH_SORT("sort", values, values.sort());
+    BENCH_SORT("std::stable_sort", values, std::stable_sort(values.begin(), values.end()));
+    BENCH_SORT("stableSort", values, values.stableSort());
+    BENCH_SORT("stableSort in place", noScratch, noScratch.stableSort());
+
+#undef BENCH_SORT
+}
+
+int main()
+{
+    for (int pattern = 0; pattern < 5; pattern++)
+    {
+        benchSort<uint32_t>("u32", 100, pattern);
+        benchSort<uint32_t>("u32", 1000000, pattern);
+    }
+
+    benchSort<uint64_t>("u64", 1000000, 0);
+    benchSort<double>("double", 1000000, 0);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,139 @@
+#ifdef UNIT_TEST
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <assert.h>
+#include <math.h>
+
+#include <limits>
+
+#include "stree_index.h"
+
+template <class T>
+struct Alloc
+{
+    T *allocate(size_t n) {return (T*)malloc(n * sizeof(T));}
+    T *reallocate(T* buf, size_t n) {return (T*)realloc((void*)buf, n * sizeof(T)); }
+    void deallocate(T *buf) {free(buf);}
+};
+
+/** Allocator that always fails. */
+template <class T>
+struct FailingAlloc
+{
+    T *allocate(size_t) {return nullptr;}
+    T *reallocate(T*, size_t) {return nullptr;}
+    void deallocate(T *) {}
+};
+
+DynArrayError theError;
+
+void errorCallback(DynArrayError error, void *context)
+{
+    theError = error;
+    (void)context;
+}
+
+/**
+ * Builds indexes of one to four levels with duplicates, ending with the largest value of the type, and compares
+ * every lookup with DynArray::lowerBound.
+ */
+template <class T> void testType()
+{
+    static const size_t sizes[] = {0, 1, 15, 16, 17, 255, 256, 272, 273, 300, 1000, 4624, 4625, 5000};
+    const T maxValue = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+    const T minValue = std::numeric_limits<T>::is_integer ? std::numeric_limits<T>::min() : -maxValue;
+
+    for (size_t count : sizes)
+    {
+        DynArray<T, Alloc<T>> sorted;
+        STreeIndex<T, Alloc<T>> index;
+
+        for (size_t i = 0; i < count; i++) assert(!sorted.add((T)(i / 2 * 3)));
+        if (count > 2) sorted[count - 1] = maxValue;
+
+        assert(!index.build(sorted));
+        assert(index.getCount() == count);
+
+        for (size_t key = 0; key < count / 2 * 3 + 3; key++)
+        {
+            assert(index.lowerBound((T)key) == sorted.lowerBound((T)key));
+            assert(index.contains((T)key) == sorted.binarySearch((T)key));
+        }
+
+        assert(index.lowerBound(minValue) == 0);
+        assert(index.lowerBound(maxValue) == sorted.lowerBound(maxValue));
+        assert(index.contains(maxValue) == (count > 2));
+    }
+}
+
+int main()
+{
+    SimdLevel detected = simdDetectLevel();
+
+    for (int level = (int)SimdLevel::SCALAR; level <= (int)detected; level++)
+    {
+        assert(simdSetLevel((SimdLevel)level) == (SimdLevel)level);
+
+        testType<int32_t>();
+        testType<uint32_t>();
+        testType<int64_t>();
+        testType<uint64_t>();
+        testType<float>();
+        testType<double>();
+    }
+
+    simdSetLevel(detected);
+
+    {
+        // Unsigned keys above the signed range.
+        DynArray<uint32_t, Alloc<uint32_t>> sorted;
+        STreeIndex<uint32_t, Alloc<uint32_t>> index;
+
+        for (uint32_t i = 0; i < 1000; i++) assert(!sorted.add(0x7fffff00u + i * 2));
+        assert(!index.build(sorted));
+
+        for (uint32_t i = 0; i < 2000; i++) assert(index.lowerBound(0x7fffff00u + i) == (ssize_t)((i + 1) / 2));
+        assert(index.lowerBound(0xffffffffu) == 1000);
+        assert(index.lowerBound(0) == 0);
+    }
+
+    {
+        // Moving and rebuilding.
+        DynArray<int32_t, Alloc<int32_t>> sorted;
+        STreeIndex<int32_t, Alloc<int32_t>> index;
+
+        for (int32_t i = 0; i < 500; i++) assert(!sorted.add(i));
+        assert(!index.build(sorted));
+        assert(!index.build(sorted));
+
+        STreeIndex<int32_t, Alloc<int32_t>> moved(static_cast<STreeIndex<int32_t, Alloc<int32_t>>&&>(index));
+        assert(moved.contains(499));
+        assert(index.getCount() == 0);
+        assert(index.lowerBound(5) == 0);
+        assert(!index.contains(5));
+
+        index = static_cast<STreeIndex<int32_t, Alloc<int32_t>>&&>(moved);
+        assert(index.lowerBound(250) == 250);
+    }
+
+    {
+        // Allocation failure.
+        DynArray<int32_t, Alloc<int32_t>> sorted;
+        STreeIndex<int32_t, FailingAlloc<int32_t>> index;
+
+        index.setErrorCb(errorCallback, nullptr);
+        assert(!sorted.add(1));
+        theError = DynArrayError::OK;
+        assert(index.build(sorted));
+        assert(theError == DynArrayError::ALLOCATION_FAILURE);
+        assert(index.getCount() == 0);
+        assert(!index.contains(1));
+    }
+
+    printf("Passed: %s %s\n", __DATE__, __TIME__);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,350 @@
+#ifndef STREE_INDEX_H
+#define STREE_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include <limits>
+#include <type_traits>
+
+#include "dynamic_array.h"
+#include "simd_predicates.h"
+
+/**
+ * Node search kernels for STreeIndex. A node is 16 keys, rank counts the keys less than x, descend walks from the
+ * root to a leaf and returns the index of the first leaf key not less than x.
+ *
+ * @param[in] tree The levels of the tree, leaves first.
+ * @param[in] offsets The offset of each level in the tree.
+ * @param[in] height The number of levels, at least one.
+ * @param[in] x The key to search for.
+ */
+// @{
+template <class T> unsigned sTreeRankScalar(const T *node, T x)
+{
+    unsigned count = 0;
+
+    for (size_t i = 0; i < 16; i++) count += (node[i] < x);
+
+    return count;
+}
+
+template <class T> size_t sTreeDescendScalar(const T *tree, const size_t *offsets, unsigned height, T x)
+{
+    size_t k = 0;
+
+    for (unsigned level = height - 1; level > 0; level--)
+    {
+        k = k * 17 + sTreeRankScalar(tree + offsets[level] + k * 16, x);
+    }
+
+    return k * 16 + sTreeRankScalar(tree + k * 16, x);
+}
+
+#ifdef SIMD_SEARCH_X86
+template <class T> SIMD_TARGET_AVX2 unsigned sTreeRankAvx2(const T *node, T x)
+{
+    typedef SimdAvx2Ops<T> Ops;
+    __m256i splat = Ops::splat(x);
+    unsigned count = 0;
+
+    for (size_t i = 0; i < 16; i += Ops::W)
+    {
+        count += __builtin_popcount(Ops::bits(Ops::lt(Ops::load(node + i), splat)));
+    }
+
+    return count;
+}
+
+template <class T> SIMD_TARGET_AVX2 size_t sTreeDescendAvx2(const T *tree, const size_t *offsets, unsigned height, T x)
+{
+    size_t k = 0;
+
+    for (unsigned level = height - 1; level > 0; level--)
+    {
+        k = k * 17 + sTreeRankAvx2(tree + offsets[level] + k * 16, x);
+    }
+
+    return k * 16 + sTreeRankAvx2(tree + k * 16, x);
+}
+
+template <class T> SIMD_TARGET_AVX512 unsigned sTreeRankAvx512(const T *node, T x)
+{
+    typedef SimdAvx512Ops<T> Ops;
+    __m512i splat = Ops::splat(x);
+    unsigned count = 0;
+
+    for (size_t i = 0; i < 16; i += Ops::W)
+    {
+        count += __builtin_popcountll(Ops::lt(_mm512_loadu_si512((const void*)(node + i)), splat));
+    }
+
+    return count;
+}
+
+template <class T> SIMD_TARGET_AVX512 size_t sTreeDescendAvx512(const T *tree, const size_t *offsets, unsigned height, T x)
+{
+    size_t k = 0;
+
+    for (unsigned level = height - 1; level > 0; level--)
+    {
+        k = k * 17 + sTreeRankAvx512(tree + offsets[level] + k * 16, x);
+    }
+
+    return k * 16 + sTreeRankAvx512(tree + k * 16, x);
+}
+#endif
+// @}
+
+/**
+ * Read-only static B+ tree (S+ tree) index over a sorted array of 4 or 8 byte numbers.
+ *
+ * The nodes hold 16 keys, one or two cache lines, and have 17 children found by arithmetic instead of pointers.
+ * Each level is found by counting the keys less than the searched one with vector compares, so a lookup in a
+ * billion keys touches 8 nodes where a binary search touches 30 elements. The leaf level is the sorted array
+ * itself, so the results are indices in the original array.
+ *
+ * Leaves are padded with the largest value of the type (infinity for floats), internal nodes hold the first key
+ * of the subtree right of each key. The memory used is about 1.07 times the sorted array.
+ *
+ * Example:
+ *
+ *   STreeIndex<uint32_t, Alloc<uint32_t>> index;
+ *
+ *   if (index.build(sortedKeys)) return -1;
+ *   ssize_t i = index.lowerBound(key); // Same as sortedKeys.lowerBound(key).
+ *
+ * @tparam T The type of elements. Integers or floating point numbers of 4 or 8 bytes. Floats mustn't be NaN.
+ * @tparam Alloc The allocator used to allocate the tree.
+ * @tparam ErrorPolicy Decides how errors are handled. See DynArrayRuntimeErrors.
+ */
+template <class T, class Alloc, class ErrorPolicy = DynArrayRuntimeErrors>
+class STreeIndex : public ErrorPolicy
+{
+    static_assert(SimdSearchable<T>::value && (sizeof(T) >= 4), "Need 4 or 8 byte numbers.");
+
+    static const unsigned maxHeight = 16; ///< 17^16 * 16 elements is more than any memory.
+
+    T *mem = nullptr; ///< The allocated buffer.
+    T *tree = nullptr; ///< The levels, leaves first. Aligned to a cache line where possible.
+    size_t n = 0; ///< The number of elements in the original array.
+    size_t size = 0; ///< The number of keys in all levels.
+    size_t offsets[maxHeight]; ///< The offset of each level in the tree.
+    unsigned height = 0; ///< The number of levels.
+    Alloc ator; ///< An instance of the allocator.
+
+    /** @returns The value the unused keys are set to. */
+    static T padding()
+    {
+        return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+    }
+
+    /**
+     * Releases the tree.
+     */
+    void destruct()
+    {
+        if (mem == nullptr) return;
+
+        ator.deallocate(mem);
+        mem = nullptr;
+        tree = nullptr;
+        n = 0;
+        size = 0;
+        height = 0;
+    }
+
+    /**
+     * Takes over the tree of another index.
+     */
+    void moveFrom(STreeIndex<T, Alloc, ErrorPolicy> &&other)
+    {
+        mem = other.mem;
+        tree = other.tree;
+        n = other.n;
+        size = other.size;
+        memcpy(offsets, other.offsets, sizeof(offsets));
+        height = other.height;
+        ator = other.ator;
+        static_cast<ErrorPolicy&>(*this) = other;
+
+        other.mem = nullptr;
+        other.tree = nullptr;
+        other.n = 0;
+        other.size = 0;
+        other.height = 0;
+    }
+
+public:
+
+    /**
+     * Initializes an empty index.
+     *
+     * @param[in] alloc An instance of the allocator used to allocate the tree.
+     */
+    STreeIndex(const Alloc &alloc = Alloc()) : ator(alloc) {}
+
+    /**
+     * Destructor. Releases the memory.
+     */
+    ~STreeIndex() {destruct();}
+
+    STreeIndex(const STreeIndex<T, Alloc, ErrorPolicy> &) = delete;
+    STreeIndex<T, Alloc, ErrorPolicy>& operator=(const STreeIndex<T, Alloc, ErrorPolicy> &) = delete;
+
+    /**
+     * Move constructor. The source index will be empty.
+     */
+    STreeIndex(STreeIndex<T, Alloc, ErrorPolicy> &&other)
+    {
+        moveFrom(static_cast<STreeIndex<T, Alloc, ErrorPolicy>&&>(other));
+    }
+
+    /**
+     * Move assignment operator. The source index will be empty.
+     */
+    STreeIndex<T, Alloc, ErrorPolicy>& operator=(STreeIndex<T, Alloc, ErrorPolicy> &&other)
+    {
+        if (this == &other) return *this;
+
+        destruct();
+        moveFrom(static_cast<STreeIndex<T, Alloc, ErrorPolicy>&&>(other));
+
+        return *this;
+    }
+
+    /**
+     * Builds the index from a sorted array in O(n), replacing the previous contents.
+     *
+     * The elements are copied, the index doesn't refer to the array afterwards.
+     *
+     * @param[in] sorted The array, sorted in ascending order.
+     * @returns Zero on success, non-zero on failure.
+     *
+     * @remarks
+     *    If we run out of memory the ALLOCATION_FAILURE error is set and the index is left empty.
+     */
+    template <class A, class G, class E> int build(const DynArray<T, A, G, E> &sorted)
+    {
+        const T *src = sorted.begin();
+        size_t count = sorted.end() - src;
+
+        destruct();
+
+        if (count == 0) return 0;
+
+        // Nodes per level, leaves first.
+        size_t nodes[maxHeight];
+        unsigned levels = 1;
+        size_t keys = 0;
+
+        nodes[0] = (count + 15) / 16;
+        while (nodes[levels - 1] > 1)
+        {
+            nodes[levels] = (nodes[levels - 1] + 16) / 17;
+            levels++;
+        }
+
+        for (unsigned level = 0; level < levels; level++)
+        {
+            offsets[level] = keys;
+            keys += nodes[level] * 16;
+        }
+
+        if (keys > SIZE_MAX / sizeof(T) - 16)
+        {
+            this->reportError(DynArrayError::ALLOCATION_FAILURE);
+            return -1;
+        }
+
+        mem = ator.allocate(keys + 16);
+        if (mem == nullptr)
+        {
+            this->reportError(DynArrayError::ALLOCATION_FAILURE);
+            return -1;
+        }
+
+        // Start the tree at a cache line, so every node is in as few lines as possible.
+        size_t offset = 0;
+        while ((offset < 16) && ((uintptr_t)(mem + offset) % 64 != 0)) offset++;
+        if (offset == 16) offset = 0;
+
+        tree = mem + offset;
+        n = count;
+        size = keys;
+        height = levels;
+
+        memcpy(tree, src, count * sizeof(T));
+        for (size_t i = count; i < nodes[0] * 16; i++) tree[i] = padding();
+
+        // Key j of node k is the first element in the subtree of child k * 17 + j + 1, the leftmost leaf of which
+        // is its index times 17^(level - 1).
+        size_t leavesPerChild = 1;
+
+        for (unsigned level = 1; level < levels; level++)
+        {
+            T *keysOfLevel = tree + offsets[level];
+
+            for (size_t k = 0; k < nodes[level]; k++)
+            {
+                for (size_t j = 0; j < 16; j++)
+                {
+                    size_t index = (k * 17 + j + 1) * leavesPerChild * 16;
+
+                    keysOfLevel[k * 16 + j] = index < count ? src[index] : padding();
+                }
+            }
+
+            leavesPerChild *= 17;
+        }
+
+        return 0;
+    }
+
+    /**
+     * Finds the first element that is not less than the given one.
+     *
+     * @param[in] elem The element to search for.
+     * @returns The index of the element in the array the index was built from, getCount() if there is none.
+     *      Same as DynArray::lowerBound.
+     */
+    ssize_t lowerBound(const T &elem) const
+    {
+        if (height == 0) return 0;
+
+        size_t index;
+
+        switch (simdGetLevel())
+        {
+#ifdef SIMD_SEARCH_X86
+            case SimdLevel::AVX512: index = sTreeDescendAvx512(tree, offsets, height, elem); break;
+            case SimdLevel::AVX2: index = sTreeDescendAvx2(tree, offsets, height, elem); break;
+#endif
+            default: index = sTreeDescendScalar(tree, offsets, height, elem); break;
+        }
+
+        return index < n ? index : n;
+    }
+
+    /**
+     * Checks if the element is in the index.
+     *
+     * @param[in] elem The element to search for.
+     * @returns True if the element is found.
+     */
+    bool contains(const T &elem) const
+    {
+        size_t index = lowerBound(elem);
+
+        return (index < n) && (tree[index] == elem);
+    }
+
+    /**
+     * @returns The number of elements in the array the index was built from.
+     */
+    size_t getCount() const {return n;}
+};
+
+#endif
@@ -0,0 +1,82 @@
+#ifdef BENCHMARK
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "benchmark.h"
+#include "stree_index.h"
+
+template <class T>
+struct Alloc
+{
+    T *allocate(size_t n) {return (T*)malloc(n * sizeof(T));}
+    T *reallocate(T* buf, size_t n) {return (T*)realloc(buf, n * sizeof(T));}
+    void deallocate(T *buf) {free(buf);}
+};
+
+static const char *levelNames[] = {"scalar", "SSE2", "AVX2", "AVX-512"};
+
+/**
+ * Looks up random keys with lowerBound on a sorted array and on an S-tree built from it, at each supported level.
+ * The sizes are picked to fit the levels of the cache hierarchy.
+ */
+template <class T> static void benchLowerBound(const char *typeName, const char *level, size_t count)
+{
+    const size_t lookups = 4 * 1024 * 1024;
+    DynArray<T, Alloc<T>> sorted;
+    DynArray<T, Alloc<T>> keys;
+    STreeIndex<T, Alloc<T>> index;
+
+    if (!sorted.appendUninitialized(count) || !keys.appendUninitialized(lookups)) return;
+    for (size_t i = 0; i < count; i++) sorted[i] = (T)(i * 2);
+
+    uint64_t state = 88172645463325252ull;
+    for (size_t i = 0; i < lookups; i++)
+    {
+        state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+        keys[i] = (T)(state % (count * 2));
+    }
+
+    char name[64];
+    size_t sum = 0;
+
+    snprintf(name, sizeof(name), "build %s %s", typeName, level);
+    double start = benchNow();
+    if (index.build(sorted)) return;
+    benchReport(name, benchNow() - start, count);
+
+    snprintf(name, sizeof(name), "lowerBound %s %s, sorted array", typeName, level);
+    start = benchNow();
+    for (size_t i = 0; i < lookups; i++) sum += sorted.lowerBound(keys[i]);
+    benchReport(name, benchNow() - start, lookups);
+
+    SimdLevel detected = simdDetectLevel();
+
+    for (int simd = (int)SimdLevel::SCALAR; simd <= (int)detected; simd++)
+    {
+        if (simd == (int)SimdLevel::SSE2) continue; // No SSE2 kernel, same as scalar.
+
+        simdSetLevel((SimdLevel)simd);
+        snprintf(name, sizeof(name), "lowerBound %s %s, S-tree %s", typeName, level, levelNames[simd]);
+        start = benchNow();
+        for (size_t i = 0; i < lookups; i++) sum -= index.lowerBound(keys[i]);
+        benchReport(name, benchNow() - start, lookups);
+    }
+
+    simdSetLevel(detected);
+    benchKeep(sum);
+}
+
+int main()
+{
+    benchLowerBound<uint32_t>("u32", "16 KB (L1)", 4 * 1024);
+    benchLowerBound<uint32_t>("u32", "1 MB (L2)", 256 * 1024);
+    benchLowerBound<uint32_t>("u32", "64 MB (L3)", 16 * 1024 * 1024);
+    benchLowerBound<uint32_t>("u32", "1 GB (DRAM)", 256 * 1024 * 1024);
+    benchLowerBound<uint64_t>("u64", "1 MB (L2)", 128 * 1024);
+    benchLowerBound<uint64_t>("u64", "1 GB (DRAM)", 128 * 1024 * 1024);
+
+    return 0;
+}
+
+#endif
@@ -0,0 +1,17 @@
+#!/bin/bash
+
+CPPFILES=`find . -name "*_bench.cpp"`
+OPTIONS="-Wall -Wextra -Werror -Wfatal-errors -pedantic -std=c++11 -fno-rtti -fno-exceptions"
+
+set -e
+
+for F in $CPPFILES
+do
+    echo
+    echo "*** Running benchmark in $F ***"
+    echo
+    g++ -I`pwd` -O2 $OPTIONS -DBENCHMARK $F -o benchprogram
+    ./benchprogram
+done
+
+echo "All done!"
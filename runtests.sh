@@ -1,6 +1,6 @@
 #!/bin/bash
 
-CPPFILES=`find . -name "*.cpp"`
+CPPFILES=`find . -name "*.cpp" ! -name "*_bench.cpp"`
 
 set -e
 